@@ -143,6 +143,17 @@ class Transpose
       */
       void setMaxAutotuningCandidates (int num) { maxAutotuningCandidates_ = num; } 
 
+      /**
+       * getSelectedCandidate() returns the rank, in HPTT's heuristic ordering,
+       * of the candidate chosen by the last call to createPlan().
+       * setSelectedCandidate() makes the next call to createPlan() use that
+       * candidate without auto-tuning, e.g., to replay an earlier hptt::MEASURE
+       * selection for the same transposition and number of threads.
+       */
+      int getSelectedCandidate() const noexcept { return selectedCandidateId_; }
+      void setSelectedCandidate(int id) noexcept { selectedCandidateId_ = id; }
+      void setSelectionMethod(SelectionMethod selectionMethod) noexcept { selectionMethod_ = selectionMethod; }
+
       /**
        * This thread-safe function adds an OpenMP threadId to the set of threads
        * that will participate in this tensor transposition. This function is
@@ -262,6 +273,7 @@ class Transpose
       int numThreads_;
       int selectedParallelStrategyId_;
       int selectedLoopOrderId_;
+      int selectedCandidateId_;
       bool conjA_;
 #ifdef _OPENMP
       omp_lock_t writelock;
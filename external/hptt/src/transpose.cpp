@@ -747,6 +747,7 @@ void transpose_int_constStride1( const floatType* __restrict__ A, floatType* __r
          maxAutotuningCandidates_(-1),
          selectedParallelStrategyId_(-1),
          selectedLoopOrderId_(-1),
+         selectedCandidateId_(-1),
          conjA_(false)
       {
 #ifdef _OPENMP
@@ -798,6 +799,7 @@ void transpose_int_constStride1( const floatType* __restrict__ A, floatType* __r
                                           selectionMethod_(other.selectionMethod_),
                                           selectedParallelStrategyId_(other.selectedParallelStrategyId_),
                                           selectedLoopOrderId_(other.selectedLoopOrderId_),
+                                          selectedCandidateId_(other.selectedCandidateId_),
                                           maxAutotuningCandidates_(other.maxAutotuningCandidates_),
                                           sizeA_(other.sizeA_),
                                           perm_(other.perm_),
@@ -1828,6 +1830,8 @@ void Transpose<floatType>::getLoopOrders(std::vector<std::vector<int> > &loopOrd
    do {
       if ( perm_[0] == 0 && loopOrder[dim_-1] != 0 )
          continue; // ATTENTION: we skip all loop-orders where the stride-1 index is not the inner-most loop iff perm[0] == 0 (both for perf & correctness)
+      if ( perm_[0] != 0 && loopOrder[dim_-1] != 0 && loopOrder[dim_-1] != perm_[0] )
+         continue; // the remainders of the macro-kernel are only correct if one of the two stride-1 indices is the inner-most loop
 
       loopOrders.push_back(loopOrder);
    } while(std::next_permutation(loopOrder.begin(), loopOrder.end()));
@@ -2039,8 +2043,12 @@ std::shared_ptr<Plan> Transpose<floatType>::selectPlan( const std::vector<std::s
       fprintf(stderr,"[HPTT] Internal error: not enough plans generated.\n");
       exit(-1);
    }
-   if( selectionMethod_ == ESTIMATE ) // fast return
+   if( selectedCandidateId_ != -1 ) // replay an earlier selection
+      return plans[std::min((int)plans.size()-1, selectedCandidateId_)];
+   if( selectionMethod_ == ESTIMATE ){ // fast return
+      selectedCandidateId_ = 0;
       return plans[0];
+   }
 
    double timeLimit = this->getTimeLimit() * 1000; //in ms
    int maxAutotuningCandidates = plans.size();
@@ -2080,6 +2088,7 @@ std::shared_ptr<Plan> Transpose<floatType>::selectPlan( const std::vector<std::s
       if( this->infoLevel_ > 0 )
          printf("We evaluated %d/%zu candidates and selected candidate %d.\n", plansEvaluated, plans.size(), bestPlan_id); 
    }
+   selectedCandidateId_ = bestPlan_id;
    return plans[bestPlan_id];
 }
 
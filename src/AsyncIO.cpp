@@ -0,0 +1,229 @@
+#include "einsums/AsyncIO.hpp"
+
+#include "einsums/Timer.hpp"
+
+#include <H5public.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace einsums::io {
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+struct Completed {
+    detail::Operation operation;
+    size_t bytes;
+    double seconds;
+};
+
+struct Queued {
+    detail::Operation operation;
+    size_t bytes;
+    std::packaged_task<void()> work;
+};
+
+struct Worker {
+    std::mutex lock;
+    std::condition_variable changed;
+    std::deque<Queued> queue;
+    bool running_work{false};
+    bool stopping{false};
+
+    Statistics totals;
+    std::vector<Completed> unrecorded;
+    std::vector<std::exception_ptr> failures;
+
+    std::thread thread;
+
+    Worker() : thread{[this] { run(); }} {}
+
+    ~Worker() { stop(); }
+
+    // Work still queued when the program ends is finished before the thread stops, unless finalize() stopped it first.
+    void run() {
+        std::unique_lock guard{lock};
+        while (true) {
+            changed.wait(guard, [this] { return stopping || !queue.empty(); });
+            if (queue.empty())
+                return;
+
+            Queued next = std::move(queue.front());
+            queue.pop_front();
+            running_work = true;
+            guard.unlock();
+            execute(next);
+            guard.lock();
+            running_work = false;
+            changed.notify_all();
+        }
+    }
+
+    // Runs the work without holding the lock.
+    void execute(Queued &next) {
+        const auto start = clock::now();
+        next.work();
+        const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+        std::lock_guard guard{lock};
+        if (next.operation == detail::Operation::Read) {
+            totals.reads++;
+            totals.bytes_read += next.bytes;
+            totals.read_seconds += seconds;
+        } else {
+            totals.writes++;
+            totals.bytes_written += next.bytes;
+            totals.write_seconds += seconds;
+        }
+        unrecorded.push_back({next.operation, next.bytes, seconds});
+    }
+
+    void stop() {
+        {
+            std::lock_guard guard{lock};
+            stopping = true;
+        }
+        changed.notify_all();
+        if (thread.joinable())
+            thread.join();
+    }
+};
+
+// Without a thread-safe HDF5 the I/O thread would race the rest of the program, so work runs on the calling thread.
+auto threadsafe_hdf5() -> bool {
+    static const bool threadsafe = [] {
+        hbool_t result{false};
+        return H5is_library_threadsafe(&result) >= 0 && result;
+    }();
+    return threadsafe;
+}
+
+auto worker() -> Worker & {
+    static Worker instance;
+    return instance;
+}
+
+// The timer tree belongs to the calling thread, so the work of the I/O thread is added to it here.
+void record_completed(Worker &io) {
+    std::vector<Completed> completed;
+    {
+        std::lock_guard guard{io.lock};
+        completed.swap(io.unrecorded);
+    }
+    for (const auto &entry : completed)
+        timer::record(entry.operation == detail::Operation::Read ? "I/O read" : "I/O write", entry.seconds, entry.bytes);
+}
+
+// Rethrows the first exception thrown by work that no wait() saw, and forgets the rest.
+void rethrow_failure(Worker &io) {
+    std::exception_ptr failure;
+    {
+        std::lock_guard guard{io.lock};
+        if (!io.failures.empty())
+            failure = io.failures.front();
+        io.failures.clear();
+    }
+    if (failure)
+        std::rethrow_exception(failure);
+}
+
+void record_stall(Worker &io, clock::time_point start) {
+    const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+    timer::record("I/O stall", seconds);
+    std::lock_guard guard{io.lock};
+    io.totals.stall_seconds += seconds;
+}
+
+} // namespace
+
+auto statistics() -> Statistics {
+    Worker &io = worker();
+    std::lock_guard guard{io.lock};
+    return io.totals;
+}
+
+void flush() {
+    Worker &io = worker();
+    const auto start = clock::now();
+    bool stalled{false};
+    {
+        std::unique_lock guard{io.lock};
+        stalled = !io.queue.empty() || io.running_work;
+        io.changed.wait(guard, [&io] { return io.queue.empty() && !io.running_work; });
+    }
+    if (stalled)
+        record_stall(io, start);
+    record_completed(io);
+    rethrow_failure(io);
+}
+
+void finalize() {
+    Worker &io = worker();
+    io.stop();
+    record_completed(io);
+    rethrow_failure(io);
+}
+
+namespace detail {
+
+auto submit(Operation operation, size_t bytes, std::function<void()> work) -> std::shared_future<void> {
+    Worker &io = worker();
+    // An exception thrown by the work is kept for flush() until a wait() sees it, from before the future is ready so that
+    // the wait always finds it.
+    std::packaged_task<void()> task{[&io, work = std::move(work)] {
+        try {
+            work();
+        } catch (...) {
+            std::lock_guard guard{io.lock};
+            io.failures.push_back(std::current_exception());
+            throw;
+        }
+    }};
+    std::shared_future<void> done = task.get_future().share();
+    Queued queued{operation, bytes, std::move(task)};
+    {
+        std::lock_guard guard{io.lock};
+        if (!io.stopping && threadsafe_hdf5()) {
+            io.queue.push_back(std::move(queued));
+            io.changed.notify_all();
+            return done;
+        }
+    }
+    // After finalize(), or without a thread-safe HDF5, the work runs on the calling thread.
+    io.execute(queued);
+    return done;
+}
+
+void wait(const std::shared_future<void> &done) {
+    Worker &io = worker();
+    if (done.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+        const auto start = clock::now();
+        done.wait();
+        record_stall(io, start);
+    }
+    record_completed(io);
+    try {
+        done.get();
+    } catch (...) {
+        // Seen here, so flush() does not throw it again.
+        const std::exception_ptr failure = std::current_exception();
+        {
+            std::lock_guard guard{io.lock};
+            io.failures.erase(std::remove(io.failures.begin(), io.failures.end(), failure), io.failures.end());
+        }
+        throw;
+    }
+}
+
+} // namespace detail
+
+} // namespace einsums::io
@@ -3,6 +3,9 @@
 
 #include <cassert>
 #include <cstdlib>
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <unistd.h>
+#endif
 
 namespace einsums::detail {
 
@@ -37,4 +40,28 @@ void deallocate_aligned_memory(void *ptr) noexcept {
     return free(ptr);
 }
 
+auto l1_data_cache_size() -> size_t {
+    static const size_t size = [] {
+#if defined(_SC_LEVEL1_DCACHE_SIZE)
+        long value = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+        if (value > 0)
+            return static_cast<size_t>(value);
+#endif
+        return size_t{32 * 1024};
+    }();
+    return size;
+}
+
+auto l2_cache_size() -> size_t {
+    static const size_t size = [] {
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+        long value = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        if (value > 0)
+            return static_cast<size_t>(value);
+#endif
+        return size_t{256 * 1024};
+    }();
+    return size;
+}
+
 } // namespace einsums::detail
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "einsums/PlanCache.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+
+namespace einsums::plan_cache {
+
+namespace {
+
+struct Cached {
+    std::shared_ptr<Plan> plan;
+    size_t last_use;
+};
+
+std::mutex lock;
+std::map<detail::Key, Cached> plans;
+size_t capacity{256};
+size_t uses{0};
+Statistics counts;
+
+// Drops the least recently used plans until there are no more than limit. A caller still holding one keeps it.
+void evict(size_t limit) {
+    while (plans.size() > limit) {
+        auto oldest = std::min_element(plans.begin(), plans.end(),
+                                       [](const auto &a, const auto &b) { return a.second.last_use < b.second.last_use; });
+        plans.erase(oldest);
+    }
+}
+
+// Wisdom outlives the process, so it is keyed by the text form of a Key rather than by its type_index.
+std::map<std::string, int> wisdom;
+
+auto wisdom_key(const detail::Key &key) -> std::string {
+    std::ostringstream out;
+    out << key.signature.name() << ' ' << key.threads << ' ' << key.shape.size();
+    for (size_t value : key.shape)
+        out << ' ' << value;
+    return out.str();
+}
+
+} // namespace
+
+auto statistics() -> Statistics {
+    std::lock_guard guard{lock};
+    Statistics result{counts};
+    result.entries = plans.size();
+    result.wisdom = wisdom.size();
+    return result;
+}
+
+void clear() {
+    std::lock_guard guard{lock};
+    plans.clear();
+    wisdom.clear();
+    counts = Statistics{};
+}
+
+void set_capacity(size_t plans) {
+    std::lock_guard guard{lock};
+    capacity = plans;
+    evict(capacity);
+}
+
+// One line per entry: the candidate followed by the key.
+void save_wisdom(const std::string &filename) {
+    std::lock_guard guard{lock};
+    std::ofstream out{filename};
+    if (!out)
+        throw std::runtime_error("plan_cache::save_wisdom: unable to open " + filename);
+    for (const auto &[key, candidate] : wisdom)
+        out << candidate << ' ' << key << '\n';
+}
+
+void load_wisdom(const std::string &filename) {
+    std::ifstream in{filename};
+    if (!in)
+        throw std::runtime_error("plan_cache::load_wisdom: unable to open " + filename);
+
+    std::lock_guard guard{lock};
+    int candidate;
+    std::string key;
+    while (in >> candidate && in.get() == ' ' && std::getline(in, key))
+        wisdom[key] = candidate;
+}
+
+namespace detail {
+
+auto Key::operator<(const Key &other) const -> bool {
+    return std::tie(signature, threads, shape) < std::tie(other.signature, other.threads, other.shape);
+}
+
+auto find(const Key &key) -> std::shared_ptr<Plan> {
+    std::lock_guard guard{lock};
+    auto found = plans.find(key);
+    if (found != plans.end()) {
+        counts.hits++;
+        found->second.last_use = ++uses;
+        return found->second.plan;
+    }
+
+    counts.misses++;
+    auto plan = std::make_shared<Plan>();
+    if (capacity != 0) {
+        evict(capacity - 1);
+        plans.emplace(key, Cached{plan, ++uses});
+    }
+    return plan;
+}
+
+auto find_wisdom(const Key &key) -> int {
+    const std::string text = wisdom_key(key);
+    std::lock_guard guard{lock};
+    auto found = wisdom.find(text);
+    return found == wisdom.end() ? -1 : found->second;
+}
+
+void add_wisdom(const Key &key, int candidate) {
+    const std::string text = wisdom_key(key);
+    std::lock_guard guard{lock};
+    wisdom[text] = candidate;
+}
+
+} // namespace detail
+
+} // namespace einsums::plan_cache
@@ -50,11 +50,16 @@ void update_indent_string() {
 }
 
 void indent() {
+    // Only the thread outside of parallel regions indents.
+    if (omp_in_parallel())
+        return;
     indent_level += 4;
     update_indent_string();
 }
 
 void deindent() {
+    if (omp_in_parallel())
+        return;
     indent_level -= 4;
     if (indent_level < 0)
         indent_level = 0;
@@ -0,0 +1,134 @@
+#include "einsums/StoragePolicy.hpp"
+
+#include <H5Ppublic.h>
+#include <H5Zpublic.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+
+namespace einsums {
+
+StoragePolicy default_storage_policy;
+
+namespace {
+
+// Registered ids of the HDF5 filter plugins.
+constexpr H5Z_filter_t lz4_filter{32004};
+constexpr H5Z_filter_t zstd_filter{32015};
+constexpr H5Z_filter_t blosc_filter{32001};
+
+auto plugin(Compression compression) -> H5Z_filter_t {
+    switch (compression) {
+    case Compression::LZ4:
+        return lz4_filter;
+    case Compression::Zstd:
+        return zstd_filter;
+    case Compression::Blosc:
+        return blosc_filter;
+    default:
+        return H5Z_FILTER_NONE;
+    }
+}
+
+void check(herr_t status, const char *what) {
+    if (status < 0)
+        throw std::runtime_error(what);
+}
+
+} // namespace
+
+auto compression_available(Compression compression) -> bool {
+    switch (compression) {
+    case Compression::None:
+        return true;
+    case Compression::Deflate:
+        return H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0;
+    case Compression::ShuffleDeflate:
+        return H5Zfilter_avail(H5Z_FILTER_SHUFFLE) > 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0;
+    default:
+        return H5Zfilter_avail(plugin(compression)) > 0;
+    }
+}
+
+namespace detail {
+
+auto chunk_dims(const StoragePolicy &policy, const std::vector<size_t> &dims, size_t element_size) -> std::vector<hsize_t> {
+    std::vector<hsize_t> chunk(dims.size());
+    for (size_t d = 0; d < dims.size(); d++) {
+        if (policy.slab_indices.empty())
+            chunk[d] = std::min(dims[d], policy.chunk_extent);
+        else if (std::find(policy.slab_indices.begin(), policy.slab_indices.end(), d) != policy.slab_indices.end())
+            chunk[d] = 1;
+        else
+            chunk[d] = dims[d];
+        // Chunks may not be larger than the dataset, nor empty.
+        chunk[d] = std::max<hsize_t>(chunk[d], 1);
+    }
+
+    auto bytes = [&] { return std::accumulate(chunk.begin(), chunk.end(), hsize_t{element_size}, std::multiplies<>()); };
+    while (!chunk.empty() && bytes() > policy.max_chunk_bytes) {
+        auto longest = std::max_element(chunk.begin(), chunk.end());
+        if (*longest == 1)
+            break;
+        *longest = (*longest + 1) / 2;
+    }
+    return chunk;
+}
+
+auto dataset_creation(const StoragePolicy &policy, const std::vector<size_t> &dims, size_t element_size, hid_t type, const void *fill)
+    -> h5::dcpl_t {
+    h5::dcpl_t dcpl{H5Pcreate(H5P_DATASET_CREATE)};
+
+    const std::vector<hsize_t> chunk = chunk_dims(policy, dims, element_size);
+    if (!chunk.empty())
+        check(H5Pset_chunk(dcpl, static_cast<int>(chunk.size()), chunk.data()), "StoragePolicy: unable to set the chunk shape");
+
+    Compression compression = policy.compression;
+    if (plugin(compression) != H5Z_FILTER_NONE && !compression_available(compression))
+        compression = Compression::ShuffleDeflate;
+
+    switch (compression) {
+    case Compression::None:
+        break;
+    case Compression::Deflate:
+        check(H5Pset_deflate(dcpl, policy.level), "StoragePolicy: unable to set deflate");
+        break;
+    case Compression::ShuffleDeflate:
+        check(H5Pset_shuffle(dcpl), "StoragePolicy: unable to set shuffle");
+        check(H5Pset_deflate(dcpl, policy.level), "StoragePolicy: unable to set deflate");
+        break;
+    case Compression::LZ4:
+        check(H5Pset_filter(dcpl, lz4_filter, H5Z_FLAG_OPTIONAL, 0, nullptr), "StoragePolicy: unable to set LZ4");
+        break;
+    case Compression::Zstd: {
+        const unsigned values[] = {policy.level};
+        check(H5Pset_filter(dcpl, zstd_filter, H5Z_FLAG_OPTIONAL, 1, values), "StoragePolicy: unable to set Zstd");
+        break;
+    }
+    case Compression::Blosc: {
+        // The first four values are filled in by the filter; then level, byte shuffle and the blosclz compressor.
+        const unsigned values[] = {0, 0, 0, 0, policy.level, 1, 0};
+        check(H5Pset_filter(dcpl, blosc_filter, H5Z_FLAG_OPTIONAL, 7, values), "StoragePolicy: unable to set Blosc");
+        break;
+    }
+    }
+
+    if (fill != nullptr)
+        check(H5Pset_fill_value(dcpl, type, fill), "StoragePolicy: unable to set the fill value");
+
+    return dcpl;
+}
+
+auto dataset_access(const StoragePolicy &policy) -> h5::dapl_t {
+    h5::dapl_t dapl{H5Pcreate(H5P_DATASET_ACCESS)};
+    if (policy.cache_bytes != 0)
+        check(H5Pset_chunk_cache(dapl, policy.cache_slots, policy.cache_bytes, policy.cache_w0),
+              "StoragePolicy: unable to set the chunk cache");
+    return dapl;
+}
+
+} // namespace detail
+
+} // namespace einsums
@@ -0,0 +1,123 @@
+#include "einsums/Telemetry.hpp"
+
+#include "einsums/Print.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+
+namespace einsums::telemetry {
+
+namespace {
+
+std::mutex lock;
+std::map<std::tuple<std::string, std::string, std::string>, Entry> recorded;
+
+auto json_string(const std::string &text) -> std::string {
+    std::string result{"\""};
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        result += c;
+    }
+    return result + '"';
+}
+
+auto gflops(const Entry &entry) -> double {
+    return entry.seconds > 0 ? entry.flops / entry.seconds * 1e-9 : 0.0;
+}
+
+} // namespace
+
+auto entries() -> std::vector<Entry> {
+    std::vector<Entry> result;
+    {
+        std::lock_guard guard{lock};
+        for (const auto &[key, entry] : recorded)
+            result.push_back(entry);
+    }
+    std::stable_sort(result.begin(), result.end(), [](const Entry &a, const Entry &b) { return a.seconds > b.seconds; });
+    return result;
+}
+
+void clear() {
+    std::lock_guard guard{lock};
+    recorded.clear();
+}
+
+auto is_fallback(const std::string &algorithm) -> bool {
+    return algorithm == "generic" || algorithm == "strided" || algorithm == "tiled" || algorithm == "link parallel";
+}
+
+void report() {
+    const auto all = entries();
+    if (all.empty())
+        return;
+
+    double total{0}, fallback{0};
+    println();
+    println("Einsum telemetry:");
+    println();
+    print::indent();
+    for (const auto &entry : all) {
+        println("{:10.3f} ms : {:6} calls : {:9.3f} GFLOP/s : {:<13} : {} {}", entry.seconds * 1e3, entry.calls, gflops(entry),
+                entry.algorithm, entry.signature, entry.dims);
+        total += entry.seconds;
+        if (is_fallback(entry.algorithm))
+            fallback += entry.seconds;
+    }
+    println();
+    println("{:.1f}% of {:.3f} ms of einsum time in fallback algorithms", total > 0 ? 100.0 * fallback / total : 0.0, total * 1e3);
+    print::deindent();
+}
+
+void dump_json(const std::string &filename) {
+    std::ofstream out{filename};
+    if (!out)
+        throw std::runtime_error("telemetry::dump_json: unable to open " + filename);
+
+    const auto all = entries();
+    out << "[\n";
+    for (size_t i = 0; i < all.size(); i++) {
+        const Entry &entry = all[i];
+        out << "  {\"signature\": " << json_string(entry.signature) << ", \"dims\": " << json_string(entry.dims)
+            << ", \"algorithm\": " << json_string(entry.algorithm) << ", \"calls\": " << entry.calls << ", \"flops\": " << entry.flops
+            << ", \"bytes\": " << entry.bytes << ", \"seconds\": " << entry.seconds << ", \"gflops\": " << gflops(entry) << "}"
+            << (i + 1 < all.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+}
+
+namespace detail {
+
+thread_local Call *current_call{nullptr};
+
+Call::Call(std::string signature, std::string dims, double flops, double bytes)
+    : signature{std::move(signature)}, dims{std::move(dims)}, flops{flops}, bytes{bytes}, _previous{current_call},
+      _start{std::chrono::steady_clock::now()} {
+    current_call = this;
+}
+
+Call::~Call() {
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - _start;
+    current_call = _previous;
+
+    std::lock_guard guard{lock};
+    Entry &entry = recorded[{signature, dims, algorithm}];
+    if (entry.calls == 0) {
+        entry.signature = signature;
+        entry.dims = dims;
+        entry.algorithm = algorithm;
+    }
+    entry.calls++;
+    entry.flops += flops;
+    entry.bytes += bytes;
+    entry.seconds += elapsed.count();
+}
+
+} // namespace detail
+
+} // namespace einsums::telemetry
@@ -0,0 +1,173 @@
+#include "einsums/TensorAlgebra.hpp"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace einsums::tensor_algebra {
+
+size_t einsum_path_memory_limit{0};
+
+size_t einsum_disk_memory_limit{size_t{1} << 30};
+
+#if defined(EINSUMS_CONTINUOUSLY_TEST_EINSUM_SAMPLES)
+size_t einsum_test_samples{EINSUMS_CONTINUOUSLY_TEST_EINSUM_SAMPLES};
+#else
+size_t einsum_test_samples{0};
+#endif
+
+namespace detail {
+
+namespace {
+
+struct PathSearch {
+    PathSearch(const std::string &output, const std::map<char, size_t> &dims, size_t memory_limit)
+        : output{output}, dims{dims}, memory_limit{memory_limit} {}
+
+    const std::string &output;
+    const std::map<char, size_t> &dims;
+    size_t memory_limit;
+
+    EinsumPath best;
+    bool have_best{false};
+    bool best_is_feasible{false};
+
+    [[nodiscard]] auto size_of(const std::string &labels) const -> size_t {
+        size_t size{1};
+        for (char label : labels)
+            size *= dims.at(label);
+        return size;
+    }
+
+    /// Labels of the result of contracting operands p and q: the labels of p then q, without repeats, that are still
+    /// needed by the output or by one of the other operands.
+    [[nodiscard]] auto contract(const std::vector<std::string> &operands, size_t p, size_t q) const -> std::string {
+        std::string result;
+        for (char label : operands[p] + operands[q]) {
+            if (result.find(label) != std::string::npos)
+                continue;
+            bool needed = output.find(label) != std::string::npos;
+            for (size_t i = 0; i < operands.size() && !needed; i++) {
+                if (i != p && i != q)
+                    needed = operands[i].find(label) != std::string::npos;
+            }
+            if (needed)
+                result += label;
+        }
+        return result;
+    }
+
+    /// Floating-point operations of contracting operands p and q: a multiply and an add for every combination of
+    /// their distinct labels.
+    [[nodiscard]] auto cost(const std::vector<std::string> &operands, size_t p, size_t q) const -> double {
+        std::string labels;
+        for (char label : operands[p] + operands[q]) {
+            if (labels.find(label) == std::string::npos)
+                labels += label;
+        }
+        return 2.0 * static_cast<double>(size_of(labels));
+    }
+
+    /// Applies the contraction (p, q) to operands and records it in path.
+    void apply(std::vector<std::string> &operands, size_t p, size_t q, EinsumPath &path) const {
+        const bool last = operands.size() == 2;
+        std::string result = last ? output : contract(operands, p, q);
+
+        path.contractions.emplace_back(p, q);
+        path.descriptions.push_back(operands[p] + "," + operands[q] + "->" + result);
+        path.flops += cost(operands, p, q);
+        if (!last)
+            path.largest_intermediate = std::max(path.largest_intermediate, size_of(result));
+
+        operands.erase(operands.begin() + q);
+        operands.erase(operands.begin() + p);
+        operands.push_back(result);
+    }
+
+    void consider(const EinsumPath &path) {
+        const bool feasible = path.largest_intermediate <= memory_limit;
+        bool better{false};
+        if (!have_best)
+            better = true;
+        else if (feasible != best_is_feasible)
+            better = feasible;
+        else if (feasible)
+            better = path.flops < best.flops;
+        else
+            better = path.largest_intermediate < best.largest_intermediate ||
+                     (path.largest_intermediate == best.largest_intermediate && path.flops < best.flops);
+
+        if (better) {
+            best = path;
+            have_best = true;
+            best_is_feasible = feasible;
+        }
+    }
+
+    void search(const std::vector<std::string> &operands, const EinsumPath &path) {
+        if (operands.size() == 1) {
+            consider(path);
+            return;
+        }
+
+        for (size_t p = 0; p < operands.size(); p++) {
+            for (size_t q = p + 1; q < operands.size(); q++) {
+                std::vector<std::string> next{operands};
+                EinsumPath next_path{path};
+                apply(next, p, q, next_path);
+                search(next, next_path);
+            }
+        }
+    }
+};
+
+} // namespace
+
+auto optimize_einsum_path(const std::string &output, std::vector<std::string> operands, const std::map<char, size_t> &dims,
+                          const std::vector<std::pair<size_t, size_t>> &fixed) -> EinsumPath {
+    size_t memory_limit = einsum_path_memory_limit;
+    PathSearch search{output, dims, memory_limit};
+
+    if (memory_limit == 0) {
+        memory_limit = search.size_of(output);
+        for (const auto &operand : operands)
+            memory_limit = std::max(memory_limit, search.size_of(operand));
+        search.memory_limit = memory_limit;
+    }
+
+    EinsumPath path;
+    for (const auto &[p, q] : fixed)
+        search.apply(operands, p, q, path);
+
+    search.search(operands, path);
+    return search.best;
+}
+
+auto greedy_einsum_step(const std::string &output, std::vector<std::string> &operands, const std::map<char, size_t> &dims,
+                        const std::vector<std::pair<size_t, size_t>> &candidates) -> size_t {
+    const PathSearch search{output, dims, 0};
+
+    size_t chosen{0};
+    double best_flops{0};
+    size_t best_size{0};
+    for (size_t n = 0; n < candidates.size(); n++) {
+        const auto [p, q] = candidates[n];
+        const double flops = search.cost(operands, p, q);
+        const size_t size = search.size_of(search.contract(operands, p, q));
+        if (n == 0 || flops < best_flops || (flops == best_flops && size < best_size)) {
+            chosen = n;
+            best_flops = flops;
+            best_size = size;
+        }
+    }
+
+    EinsumPath path;
+    search.apply(operands, candidates[chosen].first, candidates[chosen].second, path);
+    return chosen;
+}
+
+} // namespace detail
+
+} // namespace einsums::tensor_algebra
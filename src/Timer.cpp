@@ -1,6 +1,8 @@
 #include "einsums/Timer.hpp"
 
+#include "einsums/OpenMP.h"
 #include "einsums/Print.hpp"
+#include "einsums/Telemetry.hpp"
 
 #include <array>
 #include <cassert>
@@ -27,6 +29,9 @@ struct TimerDetail {
     // Number of times the timer has been called
     size_t total_calls{0};
 
+    // Bytes moved by the recorded calls, if any
+    size_t total_bytes{0};
+
     TimerDetail *parent;
     std::map<std::string, TimerDetail> children;
     std::vector<std::string> order;
@@ -73,6 +78,11 @@ void print_timer_info(TimerDetail *timer) { // NOLINT
                      timer->total_calls, duration_cast<milliseconds>(timer->total_time) / timer->total_calls);
         else
             snprintf(buffer.data(), 512, "total_calls == 0!!!");
+        if (timer->total_calls != 0 && timer->total_bytes != 0) {
+            const double seconds = std::chrono::duration<double>(timer->total_time).count();
+            const size_t length = strlen(buffer.data());
+            snprintf(buffer.data() + length, 512 - length, " : %8.1f MB/s", seconds > 0 ? timer->total_bytes / seconds * 1e-6 : 0.0);
+        }
         println("{0:<{1}} : {3: <{4}}{2}", const_cast<const char *>(buffer.data()), 70 - print::current_indent_level(), timer->name, "",
                 print::current_indent_level());
 #pragma clang diagnostic pop
@@ -98,12 +108,18 @@ void print_timer_info(TimerDetail *timer) { // NOLINT
 
 void report() {
     print_timer_info(root);
+    telemetry::report();
 }
 
 void push(const std::string &name) {
     // assert(current_timer != nullptr);
     static bool already_warned{false};
 
+    // The timer tree belongs to the thread that initialized it. Work run on the threads of a parallel region, such as
+    // the blocks of a block-sparse einsum, is timed by the caller around the region.
+    if (omp_in_parallel())
+        return;
+
     if (current_timer == nullptr) {
         if (already_warned == false) {
             println("Timer::push: Timer was not initialized prior to calling `push`. This is the only warning you will receive.");
@@ -122,9 +138,28 @@ void push(const std::string &name) {
     current_timer->start_time = clock::now();
 }
 
+void record(const std::string &name, double seconds, size_t bytes) {
+    if (omp_in_parallel() || current_timer == nullptr)
+        return;
+
+    if (current_timer->children.count(name) == 0) {
+        current_timer->children[name].name = name;
+        current_timer->children[name].parent = current_timer;
+        current_timer->order.push_back(name);
+    }
+
+    TimerDetail &timer = current_timer->children[name];
+    timer.total_time += std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(seconds));
+    timer.total_calls++;
+    timer.total_bytes += bytes;
+}
+
 void pop() {
     static bool already_warned{false};
 
+    if (omp_in_parallel())
+        return;
+
     if (current_timer == nullptr) {
         if (already_warned == false) {
             println("Timer::pop: current_timer is already nullptr; something might be wrong. This is the only warning you will receive.");
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <future>
+
+namespace einsums::io {
+
+/// Totals of the work of the I/O thread, and of the time spent waiting for it.
+struct Statistics {
+    size_t reads{0};
+    size_t writes{0};
+    size_t bytes_read{0};
+    size_t bytes_written{0};
+    double read_seconds{0};
+    double write_seconds{0};
+    double stall_seconds{0};
+};
+
+auto statistics() -> Statistics;
+
+/**
+ * Waits until every read and write queued on the I/O thread is done. Rethrows the first exception thrown by queued work
+ * whose future was not waited for, such as the write-behind of a view, since the last flush.
+ */
+void flush();
+
+/**
+ * Finishes the queued work and stops the I/O thread, rethrowing as flush() does. Call it before the HDF5 files are
+ * closed at the end of the program; work queued afterwards runs on the calling thread.
+ */
+void finalize();
+
+namespace detail {
+
+enum class Operation { Read, Write };
+
+/**
+ * Queues work on the I/O thread, which is started on first use and runs the work in the order it was queued. The thread
+ * calls HDF5 alongside the rest of the program, so unless HDF5 was built thread-safe the work runs on the calling thread
+ * before submit returns.
+ */
+auto submit(Operation operation, size_t bytes, std::function<void()> work) -> std::shared_future<void>;
+
+/**
+ * Waits for queued work. Time spent blocked is recorded as "I/O stall" in the timer tree, and the work the I/O thread
+ * finished since the last wait as "I/O read" and "I/O write", with their throughput. Rethrows an exception thrown by
+ * the work.
+ */
+void wait(const std::shared_future<void> &done);
+
+} // namespace detail
+
+} // namespace einsums::io
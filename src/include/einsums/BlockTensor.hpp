@@ -0,0 +1,251 @@
+#pragma once
+
+#include "einsums/OpenMP.h"
+#include "einsums/Section.hpp"
+#include "einsums/Tensor.hpp"
+#include "einsums/TensorAlgebra.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace einsums {
+
+/**
+ * Tensor whose indices are each partitioned into blocks, for instance by irrep or spin, and of which only the nonzero
+ * blocks are stored. Each stored block is a dense Tensor; any block not stored is exactly zero.
+ */
+template <typename T, size_t Rank>
+struct BlockTensor {
+    using Coordinate = std::array<size_t, Rank>;
+
+    BlockTensor() = default;
+
+    /// partition[d] lists the extents of the blocks of index d.
+    BlockTensor(std::string name, std::array<std::vector<size_t>, Rank> partition)
+        : _name{std::move(name)}, _partition{std::move(partition)} {
+        for (size_t d = 0; d < Rank; d++) {
+            _offsets[d].resize(_partition[d].size());
+            std::exclusive_scan(_partition[d].begin(), _partition[d].end(), _offsets[d].begin(), size_t{0});
+        }
+    }
+
+    /// The block at the given coordinate, created and zeroed if it is not stored yet.
+    auto block(const Coordinate &coordinate) -> Tensor<T, Rank> & {
+        auto found = _blocks.find(coordinate);
+        if (found != _blocks.end())
+            return found->second;
+
+        Dim<Rank> dims = block_dims(coordinate);
+        Tensor<T, Rank> created{dims};
+        created.set_name(fmt::format("{} block ({})", _name, fmt::join(coordinate, ", ")));
+        created.zero();
+        return _blocks.emplace(coordinate, std::move(created)).first->second;
+    }
+
+    [[nodiscard]] auto has_block(const Coordinate &coordinate) const -> bool { return _blocks.count(coordinate) != 0; }
+    [[nodiscard]] auto blocks() const -> const std::map<Coordinate, Tensor<T, Rank>> & { return _blocks; }
+    auto blocks() -> std::map<Coordinate, Tensor<T, Rank>> & { return _blocks; }
+
+    [[nodiscard]] auto block_dims(const Coordinate &coordinate) const -> Dim<Rank> {
+        Dim<Rank> dims;
+        for (size_t d = 0; d < Rank; d++) {
+            if (coordinate[d] >= _partition[d].size())
+                throw std::runtime_error(fmt::format("BlockTensor {}: block coordinate out of range", _name));
+            dims[d] = _partition[d][coordinate[d]];
+        }
+        return dims;
+    }
+
+    /// Element at the given indices of the full tensor; zero in blocks that are not stored.
+    template <typename... Indices>
+    [[nodiscard]] auto operator()(Indices... indices) const -> T {
+        static_assert(sizeof...(Indices) == Rank, "BlockTensor: number of indices does not match the rank");
+        const std::array<size_t, Rank> index{static_cast<size_t>(indices)...};
+        Coordinate coordinate;
+        std::array<size_t, Rank> within;
+        for (size_t d = 0; d < Rank; d++) {
+            const auto &offsets = _offsets[d];
+            coordinate[d] = std::upper_bound(offsets.begin(), offsets.end(), index[d]) - offsets.begin() - 1;
+            within[d] = index[d] - offsets[coordinate[d]];
+        }
+        auto found = _blocks.find(coordinate);
+        if (found == _blocks.end())
+            return T{0};
+        return std::apply(found->second, within);
+    }
+
+    /// The tensor with every block written into place.
+    [[nodiscard]] auto dense() const -> Tensor<T, Rank> {
+        Tensor<T, Rank> result{dims()};
+        result.set_name(_name);
+        result.zero();
+        for (const auto &[coordinate, block] : _blocks) {
+            Offset<Rank> offset;
+            for (size_t d = 0; d < Rank; d++)
+                offset[d] = _offsets[d][coordinate[d]];
+            TensorView<T, Rank> view{result, block.dims(), offset};
+            view = block;
+        }
+        return result;
+    }
+
+    void zero() {
+        for (auto &[coordinate, block] : _blocks)
+            block.zero();
+    }
+
+    [[nodiscard]] auto partition(int d) const -> const std::vector<size_t> & { return _partition[d]; }
+
+    [[nodiscard]] auto dim(int d) const -> size_t { return std::accumulate(_partition[d].begin(), _partition[d].end(), size_t{0}); }
+    [[nodiscard]] auto dims() const -> Dim<Rank> {
+        Dim<Rank> result;
+        for (size_t d = 0; d < Rank; d++)
+            result[d] = dim(d);
+        return result;
+    }
+
+    [[nodiscard]] auto name() const -> const std::string & { return _name; }
+    void set_name(const std::string &name) { _name = name; }
+
+  private:
+    std::string _name{"(Unnamed)"};
+    std::array<std::vector<size_t>, Rank> _partition;
+    std::array<std::vector<size_t>, Rank> _offsets;
+    std::map<Coordinate, Tensor<T, Rank>> _blocks;
+};
+
+namespace tensor_algebra {
+
+/**
+ * Block-sparse C = C_prefactor * C + AB_prefactor * A * B. Only pairs of stored blocks of A and B that agree on the
+ * blocks of their shared indices are contracted, each by the dense einsum. Pairs writing to the same block of C are
+ * run in turn by one thread; the blocks of C are shared between the threads largest first by flops, with dynamic
+ * scheduling. With fewer blocks of C than threads the blocks are run one after the other, each using every thread.
+ *
+ * Indices shared by two tensors must be partitioned the same way in both. Blocks of C not written by any pair are
+ * scaled by C_prefactor, as they would be by a dense einsum.
+ */
+template <typename T, size_t CRank, size_t ARank, size_t BRank, typename... CIndices, typename... AIndices, typename... BIndices,
+          typename U>
+auto einsum(const U UC_prefactor, const std::tuple<CIndices...> &C_indices, BlockTensor<T, CRank> *C, const U UAB_prefactor,
+            const std::tuple<AIndices...> &A_indices, const BlockTensor<T, ARank> &A, const std::tuple<BIndices...> &B_indices,
+            const BlockTensor<T, BRank> &B) -> std::enable_if_t<std::is_arithmetic_v<U>> {
+    static_assert(sizeof...(CIndices) == CRank && sizeof...(AIndices) == ARank && sizeof...(BIndices) == BRank,
+                  "einsum: number of indices does not match the rank");
+    static_assert(((detail::find_position<CIndices, AIndices...>() >= 0 || detail::find_position<CIndices, BIndices...>() >= 0) && ...),
+                  "einsum: every index of C must be an index of A or B");
+
+    Section section{fmt::format(R"(einsum: block-sparse "{}"{} = "{}"{} * "{}"{})", C->name(), print_tuple_no_type(C_indices), A.name(),
+                                print_tuple_no_type(A_indices), B.name(), print_tuple_no_type(B_indices))};
+
+    const T C_prefactor = UC_prefactor;
+    const T AB_prefactor = UAB_prefactor;
+
+    // Indices shared between tensors must be blocked alike.
+    auto check_partition = [](const auto &X, size_t x, const auto &Y, int y) {
+        if (y >= 0 && X.partition(x) != Y.partition(y))
+            throw std::runtime_error("einsum: an index is partitioned into blocks differently in two tensors");
+    };
+    for_sequence<ARank>([&](auto a) {
+        check_partition(A, a, B, detail::find_position<std::tuple_element_t<a, std::tuple<AIndices...>>, BIndices...>());
+        check_partition(A, a, *C, detail::find_position<std::tuple_element_t<a, std::tuple<AIndices...>>, CIndices...>());
+    });
+    for_sequence<BRank>([&](auto b) {
+        check_partition(B, b, *C, detail::find_position<std::tuple_element_t<b, std::tuple<BIndices...>>, CIndices...>());
+    });
+
+    struct Pair {
+        const Tensor<T, ARank> *a;
+        const Tensor<T, BRank> *b;
+    };
+    struct Work {
+        Tensor<T, CRank> *c{nullptr};
+        std::vector<Pair> pairs;
+        double flops{0};
+    };
+
+    // Enumerate the pairs of blocks that agree on their shared indices, grouped by the block of C they write.
+    std::map<typename BlockTensor<T, CRank>::Coordinate, Work> work;
+    for (const auto &[a_coordinate, a_block] : A.blocks()) {
+        for (const auto &[b_coordinate, b_block] : B.blocks()) {
+            bool compatible{true};
+            for_sequence<BRank>([&](auto b) {
+                constexpr int a = detail::find_position<std::tuple_element_t<b, std::tuple<BIndices...>>, AIndices...>();
+                if constexpr (a >= 0)
+                    compatible = compatible && a_coordinate[a] == b_coordinate[b];
+            });
+            if (!compatible)
+                continue;
+
+            typename BlockTensor<T, CRank>::Coordinate c_coordinate;
+            for_sequence<CRank>([&](auto c) {
+                using Index = std::tuple_element_t<c, std::tuple<CIndices...>>;
+                constexpr int a = detail::find_position<Index, AIndices...>();
+                constexpr int b = detail::find_position<Index, BIndices...>();
+                if constexpr (a >= 0)
+                    c_coordinate[c] = a_coordinate[a];
+                else
+                    c_coordinate[c] = b_coordinate[b];
+            });
+
+            // Blocks of C are created here, before any thread writes to them.
+            Work &entry = work[c_coordinate];
+            if (entry.c == nullptr)
+                entry.c = &C->block(c_coordinate);
+            entry.pairs.push_back({&a_block, &b_block});
+            entry.flops += detail::einsum_flops(c_unique_t<std::tuple<CIndices..., AIndices..., BIndices...>>(), C_indices, *entry.c,
+                                                A_indices, a_block, B_indices, b_block);
+        }
+    }
+
+    for (auto &[coordinate, block] : C->blocks()) {
+        if (work.count(coordinate) == 0) {
+            if (C_prefactor == T{0})
+                block.zero();
+            else
+                std::for_each(block.data(), block.data() + block.size(), [&](T &value) { value *= C_prefactor; });
+        }
+    }
+
+    std::vector<Work *> order;
+    order.reserve(work.size());
+    for (auto &[coordinate, entry] : work)
+        order.push_back(&entry);
+    std::stable_sort(order.begin(), order.end(), [](const Work *x, const Work *y) { return x->flops > y->flops; });
+
+    auto run = [&](Work &entry) {
+        for (size_t n = 0; n < entry.pairs.size(); n++) {
+            detail::einsum<false>(n == 0 ? C_prefactor : T{1}, C_indices, entry.c, AB_prefactor, A_indices, *entry.pairs[n].a,
+                                  B_indices, *entry.pairs[n].b);
+        }
+    };
+
+    const auto count = static_cast<std::ptrdiff_t>(order.size());
+    if (omp_get_max_threads() > 1 && order.size() >= static_cast<size_t>(omp_get_max_threads())) {
+#pragma omp parallel for schedule(dynamic, 1)
+        for (std::ptrdiff_t w = 0; w < count; w++)
+            run(*order[w]);
+    } else {
+        for (std::ptrdiff_t w = 0; w < count; w++)
+            run(*order[w]);
+    }
+}
+
+template <typename T, size_t CRank, size_t ARank, size_t BRank, typename... CIndices, typename... AIndices, typename... BIndices>
+void einsum(const std::tuple<CIndices...> &C_indices, BlockTensor<T, CRank> *C, const std::tuple<AIndices...> &A_indices,
+            const BlockTensor<T, ARank> &A, const std::tuple<BIndices...> &B_indices, const BlockTensor<T, BRank> &B) {
+    einsum(0, C_indices, C, 1, A_indices, A, B_indices, B);
+}
+
+} // namespace tensor_algebra
+
+} // namespace einsums
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+// Process-wide cache of the HPTT plans built by sort, so that repeated calls with the same indices and shapes skip
+// planning. Only plans that are expensive to build are kept; einsum picks its algorithm afresh on every call.
+namespace einsums::plan_cache {
+
+struct Statistics {
+    size_t hits{0};
+    size_t misses{0};
+    size_t entries{0};
+    size_t wisdom{0};
+};
+
+auto statistics() -> Statistics;
+
+/// Drops every cached plan and all wisdom, and resets the statistics.
+void clear();
+
+/// Most plans kept at once, 256 by default. Past it the least recently used plan is dropped; zero keeps none.
+void set_capacity(size_t plans);
+
+/**
+ * Wisdom is the outcome of measured planning: for each transposition sort has tuned, the candidate HPTT selected.
+ * Saving it lets later runs rebuild the tuned plans without measuring again. Loading merges the file into the
+ * wisdom already held. Both throw std::runtime_error if the file cannot be opened.
+ */
+void save_wisdom(const std::string &filename);
+void load_wisdom(const std::string &filename);
+
+struct Plan {
+    /// Guards the members below. A thread that finds it locked plans for itself instead of waiting.
+    std::mutex mutex;
+
+    /// HPTT transpose plan, an hptt::Transpose<T> for the data type in the key.
+    std::shared_ptr<void> transpose;
+};
+
+namespace detail {
+
+/// Identifies a problem: the instantiation of the caller (index tuples and types), the shapes of the operands, and the
+/// number of threads.
+struct Key {
+    std::type_index signature;
+    std::vector<size_t> shape;
+    int threads;
+
+    auto operator<(const Key &other) const -> bool;
+};
+
+/// Returns the plan for key, creating an empty one on a miss.
+auto find(const Key &key) -> std::shared_ptr<Plan>;
+
+/// Candidate recorded for key by measured planning, or -1 if there is none.
+auto find_wisdom(const Key &key) -> int;
+void add_wisdom(const Key &key, int candidate);
+
+template <template <typename, size_t> typename TensorType, typename T, size_t Rank>
+void append_shape(std::vector<size_t> &shape, const TensorType<T, Rank> &tensor) {
+    if constexpr (Rank != 0) {
+        for (size_t d = 0; d < Rank; d++) {
+            shape.push_back(tensor.dim(d));
+            shape.push_back(tensor.stride(d));
+        }
+    }
+    shape.push_back(tensor.full_view_of_underlying());
+}
+
+/// Key made of the dims, strides, and contiguity of each tensor.
+template <typename Signature, typename... TensorTypes>
+auto make_key(int threads, const TensorTypes &...tensors) -> Key {
+    std::vector<size_t> shape;
+    (append_shape(shape, tensors), ...);
+    return Key{std::type_index(typeid(Signature)), std::move(shape), threads};
+}
+
+} // namespace detail
+
+} // namespace einsums::plan_cache
@@ -407,6 +407,11 @@ struct CircularBuffer {
 namespace detail {
 auto allocate_aligned_memory(size_t align, size_t size) -> void *;
 void deallocate_aligned_memory(void *ptr) noexcept;
+
+/// Size in bytes of the level 1 data cache of the processor, or a typical value if it cannot be determined.
+auto l1_data_cache_size() -> size_t;
+/// Size in bytes of the level 2 cache of the processor, or a typical value if it cannot be determined.
+auto l2_cache_size() -> size_t;
 } // namespace detail
 
 template <typename T, size_t Align = 32>
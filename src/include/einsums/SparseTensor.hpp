@@ -0,0 +1,459 @@
+#pragma once
+
+#include "einsums/LinearAlgebra.hpp"
+#include "einsums/OpenMP.h"
+#include "einsums/Section.hpp"
+#include "einsums/Telemetry.hpp"
+#include "einsums/Tensor.hpp"
+#include "einsums/TensorAlgebra.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace einsums {
+
+/**
+ * Tensor that stores only its nonzero elements.
+ *
+ * Elements are inserted in coordinate (COO) form, in any order, and compress() turns them into compressed sparse fibers
+ * (CSF): a tree with one level per index, where each node of a level holds one value of that index and points at the
+ * range of its children in the next level. The nodes of the first level are the root fibers, the leaves are the
+ * nonzeros. For a matrix this is CSR. Inserting into a compressed tensor keeps the new elements aside until the next
+ * compress(); elements inserted twice are added.
+ */
+template <typename T, size_t Rank>
+struct SparseTensor {
+    using Coordinate = std::array<size_t, Rank>;
+
+    SparseTensor() = default;
+
+    template <typename... Dims>
+    explicit SparseTensor(std::string name, Dims... dims) : _name{std::move(name)}, _dims{static_cast<size_t>(dims)...} {
+        static_assert(Rank == sizeof...(dims), "Declared Rank does not match provided dims");
+    }
+
+    SparseTensor(std::string name, const Dim<Rank> &dims) : _name{std::move(name)} {
+        std::copy(dims.begin(), dims.end(), _dims.begin());
+    }
+
+    /// Keeps the elements of a dense tensor whose magnitude is above threshold.
+    explicit SparseTensor(const Tensor<T, Rank> &dense, double threshold = 0.0) : SparseTensor(dense.name(), dense.dims()) {
+        const T *data = dense.data();
+        for (size_t n = 0; n < dense.size(); n++) {
+            if (std::abs(data[n]) > threshold) {
+                Coordinate coordinate;
+                size_t remainder = n;
+                for (size_t d = 0; d < Rank; d++) {
+                    coordinate[d] = remainder / dense.stride(d);
+                    remainder %= dense.stride(d);
+                }
+                insert(coordinate, data[n]);
+            }
+        }
+        compress();
+    }
+
+    void insert(const Coordinate &coordinate, T value) {
+        for (size_t d = 0; d < Rank; d++) {
+            if (coordinate[d] >= _dims[d])
+                throw std::runtime_error(fmt::format("SparseTensor {}: coordinate out of range", _name));
+        }
+        _pending.emplace_back(coordinate, value);
+    }
+
+    /// Sorts the inserted elements, adds duplicates together and builds the fibers.
+    void compress() {
+        if (_pending.empty())
+            return;
+
+        std::vector<std::pair<Coordinate, T>> entries;
+        entries.reserve(nnz() + _pending.size());
+        for (size_t root = 0; root < fibers(); root++)
+            for_each_in_fiber(root, [&](const Coordinate &coordinate, T value) { entries.emplace_back(coordinate, value); });
+        entries.insert(entries.end(), _pending.begin(), _pending.end());
+        _pending.clear();
+
+        std::stable_sort(entries.begin(), entries.end(), [](const auto &x, const auto &y) { return x.first < y.first; });
+
+        for (auto &ids : _ids)
+            ids.clear();
+        for (auto &pointers : _pointers)
+            pointers.clear();
+        _values.clear();
+
+        for (size_t n = 0; n < entries.size(); n++) {
+            const Coordinate &coordinate = entries[n].first;
+            if (n > 0 && coordinate == entries[n - 1].first) {
+                _values.back() += entries[n].second;
+                continue;
+            }
+
+            // The first index at which this element leaves the fibers of the previous one.
+            size_t level = 0;
+            if (n > 0) {
+                while (coordinate[level] == entries[n - 1].first[level])
+                    level++;
+            }
+            for (; level < Rank; level++) {
+                if (level + 1 < Rank)
+                    _pointers[level].push_back(_ids[level + 1].size());
+                _ids[level].push_back(coordinate[level]);
+            }
+            _values.push_back(entries[n].second);
+        }
+        for (size_t level = 0; level + 1 < Rank; level++)
+            _pointers[level].push_back(_ids[level + 1].size());
+    }
+
+    [[nodiscard]] auto is_compressed() const -> bool { return _pending.empty(); }
+
+    /// Number of stored elements, once compressed.
+    [[nodiscard]] auto nnz() const -> size_t { return _values.size(); }
+
+    /// Number of root fibers, the distinct values of the first index.
+    [[nodiscard]] auto fibers() const -> size_t { return _ids[0].size(); }
+
+    /// Calls f(coordinate, value) for every nonzero under the given root fiber, in order.
+    template <typename F>
+    void for_each_in_fiber(size_t root, F &&f) const {
+        Coordinate coordinate;
+        visit<0>(root, coordinate, f);
+    }
+
+    /// The index values of the nodes of a level, and the ranges of their children in the next level.
+    [[nodiscard]] auto fiber_ids(size_t level) const -> const std::vector<size_t> & { return _ids[level]; }
+    [[nodiscard]] auto fiber_pointers(size_t level) const -> const std::vector<size_t> & { return _pointers[level]; }
+    [[nodiscard]] auto values() const -> const std::vector<T> & { return _values; }
+
+    /// Element at the given indices; zero if it is not stored. The tensor must be compressed.
+    template <typename... Indices>
+    [[nodiscard]] auto operator()(Indices... indices) const -> T {
+        static_assert(sizeof...(Indices) == Rank, "SparseTensor: number of indices does not match the rank");
+        if (!is_compressed())
+            throw std::runtime_error(fmt::format("SparseTensor {}: compress() before reading elements", _name));
+
+        const std::array<size_t, Rank> index{static_cast<size_t>(indices)...};
+        size_t begin = 0, end = _ids[0].size();
+        for (size_t level = 0; level < Rank; level++) {
+            auto first = _ids[level].begin() + begin, last = _ids[level].begin() + end;
+            auto found = std::lower_bound(first, last, index[level]);
+            if (found == last || *found != index[level])
+                return T{0};
+            const size_t node = found - _ids[level].begin();
+            if (level + 1 == Rank)
+                return _values[node];
+            begin = _pointers[level][node];
+            end = _pointers[level][node + 1];
+        }
+        return T{0};
+    }
+
+    [[nodiscard]] auto dense() const -> Tensor<T, Rank> {
+        if (!is_compressed())
+            throw std::runtime_error(fmt::format("SparseTensor {}: compress() before converting to a dense tensor", _name));
+
+        Tensor<T, Rank> result{dims()};
+        result.set_name(_name);
+        result.zero();
+        T *data = result.data();
+#pragma omp parallel for
+        for (size_t root = 0; root < fibers(); root++) {
+            for_each_in_fiber(root, [&](const Coordinate &coordinate, T value) {
+                size_t ordinal = 0;
+                for (size_t d = 0; d < Rank; d++)
+                    ordinal += coordinate[d] * result.stride(d);
+                data[ordinal] = value;
+            });
+        }
+        return result;
+    }
+
+    [[nodiscard]] auto dim(int d) const -> size_t { return _dims[d]; }
+    [[nodiscard]] auto dims() const -> Dim<Rank> {
+        Dim<Rank> result;
+        std::copy(_dims.begin(), _dims.end(), result.begin());
+        return result;
+    }
+
+    [[nodiscard]] auto name() const -> const std::string & { return _name; }
+    void set_name(const std::string &name) { _name = name; }
+
+  private:
+    template <size_t Level, typename F>
+    void visit(size_t node, Coordinate &coordinate, F &f) const {
+        coordinate[Level] = _ids[Level][node];
+        if constexpr (Level + 1 == Rank) {
+            f(static_cast<const Coordinate &>(coordinate), _values[node]);
+        } else {
+            for (size_t child = _pointers[Level][node]; child < _pointers[Level][node + 1]; child++)
+                visit<Level + 1>(child, coordinate, f);
+        }
+    }
+
+    std::string _name{"(Unnamed)"};
+    std::array<size_t, Rank> _dims{};
+
+    std::array<std::vector<size_t>, Rank> _ids;
+    std::array<std::vector<size_t>, (Rank > 1 ? Rank - 1 : 1)> _pointers;
+    std::vector<T> _values;
+
+    std::vector<std::pair<Coordinate, T>> _pending;
+};
+
+namespace linear_algebra {
+
+/**
+ * Sparse-dense matrix product C = beta * C + alpha * op(A) * op(B) with A stored as CSR. Without TransA the rows of C
+ * are shared between the threads; with it the columns are, since each row of A then scatters into several rows of C.
+ */
+template <bool TransA, bool TransB, template <typename, size_t> typename BType, template <typename, size_t> typename CType, typename T>
+auto gemm(const T alpha, const SparseTensor<T, 2> &A, const BType<T, 2> &B, const T beta, CType<T, 2> *C)
+    -> std::enable_if_t<is_incore_rank_tensor_v<BType<T, 2>, 2, T> && is_incore_rank_tensor_v<CType<T, 2>, 2, T>> {
+    Section section(fmt::format("sparse gemm<{}, {}>", TransA, TransB));
+
+    const size_t m = C->dim(0), n = C->dim(1), k = TransA ? A.dim(0) : A.dim(1);
+    if ((TransA ? A.dim(1) : A.dim(0)) != m || (TransB ? B.dim(1) : B.dim(0)) != k || (TransB ? B.dim(0) : B.dim(1)) != n)
+        throw std::runtime_error("sparse gemm: dimensions of A, B and C do not match");
+    if (!A.is_compressed())
+        throw std::runtime_error(fmt::format("sparse gemm: {} must be compressed", A.name()));
+
+    // Views need not have unit stride along either index.
+    const size_t b_row = TransB ? B.stride(1) : B.stride(0), b_column = TransB ? B.stride(0) : B.stride(1);
+    const size_t ldc = C->stride(0), c_column = C->stride(1);
+    const T *b = B.data();
+    T *c = C->data();
+
+#pragma omp parallel for
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++)
+            c[i * ldc + j * c_column] = beta == T{0} ? T{0} : beta * c[i * ldc + j * c_column];
+    }
+
+    const auto &rows = A.fiber_ids(0);
+    const auto &pointers = A.fiber_pointers(0);
+    const auto &columns = A.fiber_ids(1);
+    const auto &values = A.values();
+
+    if constexpr (!TransA) {
+#pragma omp parallel for schedule(dynamic)
+        for (size_t root = 0; root < rows.size(); root++) {
+            T *c_row = c + rows[root] * ldc;
+            for (size_t nz = pointers[root]; nz < pointers[root + 1]; nz++) {
+                const T a = alpha * values[nz];
+                const T *b_row_start = b + columns[nz] * b_row;
+#pragma omp simd
+                for (size_t j = 0; j < n; j++)
+                    c_row[j * c_column] += a * b_row_start[j * b_column];
+            }
+        }
+    } else {
+#pragma omp parallel
+        {
+            const size_t threads = omp_get_num_threads(), thread = omp_get_thread_num();
+            const size_t first = n * thread / threads, last = n * (thread + 1) / threads;
+            for (size_t root = 0; root < rows.size(); root++) {
+                const T *b_row_start = b + rows[root] * b_row;
+                for (size_t nz = pointers[root]; nz < pointers[root + 1]; nz++) {
+                    const T a = alpha * values[nz];
+                    T *c_row = c + columns[nz] * ldc;
+                    for (size_t j = first; j < last; j++)
+                        c_row[j * c_column] += a * b_row_start[j * b_column];
+                }
+            }
+        }
+    }
+}
+
+} // namespace linear_algebra
+
+namespace tensor_algebra {
+
+/**
+ * Sparse-dense C = C_prefactor * C + AB_prefactor * A * B into a dense C. The work is one pass over the nonzeros of A,
+ * each multiplying the elements of B it meets along the indices of B that are not indices of A, so the cost grows with
+ * the number of nonzeros rather than with the dimensions of A.
+ *
+ * The root fibers of A are shared between the threads. When the first index of A is an index of C they write disjoint
+ * parts of C; otherwise the updates of C are atomic. C(i,j) = A(i,k) B(k,j), with B possibly transposed, runs as a
+ * sparse gemm.
+ */
+template <typename T, size_t CRank, size_t ARank, size_t BRank, template <typename, size_t> typename BType, typename... CIndices,
+          typename... AIndices, typename... BIndices, typename U>
+auto einsum(const U UC_prefactor, const std::tuple<CIndices...> &C_indices, Tensor<T, CRank> *C, const U UAB_prefactor,
+            const std::tuple<AIndices...> &A_indices, const SparseTensor<T, ARank> &A, const std::tuple<BIndices...> &B_indices,
+            const BType<T, BRank> &B) -> std::enable_if_t<std::is_arithmetic_v<U> && is_incore_rank_tensor_v<BType<T, BRank>, BRank, T>> {
+    static_assert(sizeof...(CIndices) == CRank && sizeof...(AIndices) == ARank && sizeof...(BIndices) == BRank,
+                  "einsum: number of indices does not match the rank");
+    static_assert(((detail::find_position<CIndices, AIndices...>() >= 0 || detail::find_position<CIndices, BIndices...>() >= 0) && ...),
+                  "einsum: every index of C must be an index of A or B");
+
+    Section section{fmt::format(R"(einsum: sparse "{}"{} = "{}"{} * "{}"{})", C->name(), print_tuple_no_type(C_indices), A.name(),
+                                print_tuple_no_type(A_indices), B.name(), print_tuple_no_type(B_indices))};
+
+    if (!A.is_compressed())
+        throw std::runtime_error(fmt::format("einsum: sparse tensor {} must be compressed", A.name()));
+
+    const T C_prefactor = UC_prefactor;
+    const T AB_prefactor = UAB_prefactor;
+
+    // Extents and strides along the indices of A, and along the indices only B has; B walks the latter for each nonzero.
+    std::array<size_t, ARank> A_stride_in_B{}, A_stride_in_C{};
+    std::vector<size_t> free_dims, free_stride_in_B, free_stride_in_C;
+    auto check = [](size_t x, size_t y) {
+        if (x != y)
+            throw std::runtime_error("einsum: sparse contraction with inconsistent dimensions");
+    };
+    for_sequence<ARank>([&](auto a) {
+        using Index = std::tuple_element_t<a, std::tuple<AIndices...>>;
+        constexpr int b = detail::find_position<Index, BIndices...>();
+        constexpr int c = detail::find_position<Index, CIndices...>();
+        if constexpr (b >= 0) {
+            check(A.dim(a), B.dim(b));
+            A_stride_in_B[a] = B.stride(b);
+        }
+        if constexpr (c >= 0) {
+            check(A.dim(a), C->dim(c));
+            A_stride_in_C[a] = C->stride(c);
+        }
+    });
+    double free_size = 1.0;
+    for_sequence<BRank>([&](auto b) {
+        using Index = std::tuple_element_t<b, std::tuple<BIndices...>>;
+        constexpr int c = detail::find_position<Index, CIndices...>();
+        if constexpr (detail::find_position<Index, AIndices...>() < 0) {
+            free_dims.push_back(B.dim(b));
+            free_stride_in_B.push_back(B.stride(b));
+            if constexpr (c >= 0) {
+                check(B.dim(b), C->dim(c));
+                free_stride_in_C.push_back(C->stride(c));
+            } else {
+                free_stride_in_C.push_back(0);
+            }
+            free_size *= B.dim(b);
+        }
+    });
+
+#if defined(EINSUMS_TELEMETRY)
+    telemetry::detail::Call call{
+        fmt::format(R"("{}"{} = "{}"{} * "{}"{})", C->name(), print_tuple_no_type(C_indices), A.name(), print_tuple_no_type(A_indices),
+                    B.name(), print_tuple_no_type(B_indices)),
+        fmt::format("{} nnz={} {}", detail::telemetry_dims(*C), A.nnz(), detail::telemetry_dims(B)), 2.0 * A.nnz() * free_size,
+        (2 * detail::element_count(*C) + detail::element_count(B)) * sizeof(T) + A.nnz() * (sizeof(T) + sizeof(size_t))};
+#endif
+
+    if constexpr (ARank == 2 && BRank == 2 && CRank == 2) {
+        using i = std::tuple_element_t<0, std::tuple<CIndices...>>;
+        using j = std::tuple_element_t<1, std::tuple<CIndices...>>;
+        using k = std::tuple_element_t<1, std::tuple<AIndices...>>;
+        if constexpr (!std::is_same_v<i, j> && !std::is_same_v<i, k> && !std::is_same_v<j, k> &&
+                      std::is_same_v<i, std::tuple_element_t<0, std::tuple<AIndices...>>>) {
+            if constexpr (std::is_same_v<std::tuple<BIndices...>, std::tuple<k, j>>) {
+                telemetry::detail::set_algorithm("spmm");
+                linear_algebra::gemm<false, false>(AB_prefactor, A, B, C_prefactor, C);
+                return;
+            } else if constexpr (std::is_same_v<std::tuple<BIndices...>, std::tuple<j, k>>) {
+                telemetry::detail::set_algorithm("spmm");
+                linear_algebra::gemm<false, true>(AB_prefactor, A, B, C_prefactor, C);
+                return;
+            }
+        }
+    }
+    telemetry::detail::set_algorithm("sparse");
+
+    T *c = C->data();
+    if (C_prefactor == T{0})
+        C->zero();
+    else
+        std::for_each(c, c + C->size(), [&](T &value) { value *= C_prefactor; });
+
+    constexpr bool disjoint = detail::find_position<std::tuple_element_t<0, std::tuple<AIndices...>>, CIndices...>() >= 0;
+    auto add = [](T *target, T value) {
+        if constexpr (disjoint) {
+            *target += value;
+        } else if constexpr (std::is_arithmetic_v<T>) {
+#pragma omp atomic
+            *target += value;
+        } else {
+#pragma omp critical(einsums_sparse_einsum)
+            *target += value;
+        }
+    };
+
+    const T *b = B.data();
+    const size_t free_rank = free_dims.size();
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t root = 0; root < A.fibers(); root++) {
+        std::vector<size_t> counter(free_rank);
+        A.for_each_in_fiber(root, [&](const typename SparseTensor<T, ARank>::Coordinate &coordinate, T value) {
+            const T scaled = AB_prefactor * value;
+            size_t b_offset = 0, c_offset = 0;
+            for (size_t d = 0; d < ARank; d++) {
+                b_offset += coordinate[d] * A_stride_in_B[d];
+                c_offset += coordinate[d] * A_stride_in_C[d];
+            }
+            if (free_rank == 0) {
+                add(c + c_offset, scaled * b[b_offset]);
+                return;
+            }
+
+            // The last free index runs innermost; the others count like an odometer.
+            const size_t last = free_rank - 1;
+            std::fill(counter.begin(), counter.end(), 0);
+            while (true) {
+                size_t b_run = b_offset, c_run = c_offset;
+                for (size_t d = 0; d < last; d++) {
+                    b_run += counter[d] * free_stride_in_B[d];
+                    c_run += counter[d] * free_stride_in_C[d];
+                }
+                for (size_t n = 0; n < free_dims[last]; n++)
+                    add(c + c_run + n * free_stride_in_C[last], scaled * b[b_run + n * free_stride_in_B[last]]);
+
+                size_t d = last;
+                while (d > 0 && ++counter[d - 1] == free_dims[d - 1])
+                    counter[--d] = 0;
+                if (d == 0)
+                    break;
+            }
+        });
+    }
+}
+
+/// Dense-sparse einsum, with the sparse tensor as the second operand.
+template <typename T, size_t CRank, size_t ARank, size_t BRank, template <typename, size_t> typename AType, typename... CIndices,
+          typename... AIndices, typename... BIndices, typename U>
+auto einsum(const U C_prefactor, const std::tuple<CIndices...> &C_indices, Tensor<T, CRank> *C, const U AB_prefactor,
+            const std::tuple<AIndices...> &A_indices, const AType<T, ARank> &A, const std::tuple<BIndices...> &B_indices,
+            const SparseTensor<T, BRank> &B)
+    -> std::enable_if_t<std::is_arithmetic_v<U> && is_incore_rank_tensor_v<AType<T, ARank>, ARank, T>> {
+    einsum(C_prefactor, C_indices, C, AB_prefactor, B_indices, B, A_indices, A);
+}
+
+template <typename T, size_t CRank, size_t ARank, size_t BRank, template <typename, size_t> typename BType, typename... CIndices,
+          typename... AIndices, typename... BIndices>
+auto einsum(const std::tuple<CIndices...> &C_indices, Tensor<T, CRank> *C, const std::tuple<AIndices...> &A_indices,
+            const SparseTensor<T, ARank> &A, const std::tuple<BIndices...> &B_indices, const BType<T, BRank> &B)
+    -> std::enable_if_t<is_incore_rank_tensor_v<BType<T, BRank>, BRank, T>> {
+    einsum(0, C_indices, C, 1, A_indices, A, B_indices, B);
+}
+
+template <typename T, size_t CRank, size_t ARank, size_t BRank, template <typename, size_t> typename AType, typename... CIndices,
+          typename... AIndices, typename... BIndices>
+auto einsum(const std::tuple<CIndices...> &C_indices, Tensor<T, CRank> *C, const std::tuple<AIndices...> &A_indices,
+            const AType<T, ARank> &A, const std::tuple<BIndices...> &B_indices, const SparseTensor<T, BRank> &B)
+    -> std::enable_if_t<is_incore_rank_tensor_v<AType<T, ARank>, ARank, T>> {
+    einsum(0, C_indices, C, 1, A_indices, A, B_indices, B);
+}
+
+} // namespace tensor_algebra
+
+} // namespace einsums
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <h5cpp/core>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace einsums {
+
+/// Filters applied to the chunks of a dataset. LZ4, Zstd and Blosc are HDF5 plugins; where the plugin is not available,
+/// shuffle and deflate are used instead.
+enum class Compression { None, Deflate, ShuffleDeflate, LZ4, Zstd, Blosc };
+
+/// How a DiskTensor is laid out and cached in its HDF5 file.
+struct StoragePolicy {
+    Compression compression{Compression::Deflate};
+    /// Deflate, Zstd or Blosc level. Deflate levels 1 to 3 are much faster than 9 for a little less compression.
+    unsigned level{9};
+
+    /// Chunk extent along each index, when no access pattern is given.
+    size_t chunk_extent{64};
+    /// Indices that each read or write fixes, as in slabs along index 0 for {0}. Chunks are then one element thick along
+    /// these indices and as long as the dataset along the others.
+    std::vector<size_t> slab_indices{};
+    /// Chunks are halved along their longest index until they are no larger than this.
+    size_t max_chunk_bytes{size_t{1} << 22};
+
+    /// Chunk cache of each open dataset, passed to H5Pset_chunk_cache. Zero keeps the HDF5 default of 1 MiB.
+    size_t cache_bytes{0};
+    size_t cache_slots{521};
+    double cache_w0{0.75};
+};
+
+/// Policy of DiskTensors created without one, and of TensorViews written to disk. Deflate level 9 in chunks of 64.
+extern StoragePolicy default_storage_policy;
+
+/// Whether the filter of the given compression is available, rather than replaced by shuffle and deflate.
+auto compression_available(Compression compression) -> bool;
+
+namespace detail {
+
+auto chunk_dims(const StoragePolicy &policy, const std::vector<size_t> &dims, size_t element_size) -> std::vector<hsize_t>;
+
+/// Dataset creation properties: chunking and filters. With a fill value, unwritten elements read as it.
+auto dataset_creation(const StoragePolicy &policy, const std::vector<size_t> &dims, size_t element_size, hid_t type = H5I_INVALID_HID,
+                      const void *fill = nullptr) -> h5::dcpl_t;
+
+/**
+ * Dataset access properties: the chunk cache. The list must outlive the dataset opened with it, as h5cpp keeps its id
+ * in the h5::ds_t.
+ */
+auto dataset_access(const StoragePolicy &policy) -> h5::dapl_t;
+
+/**
+ * Creates a dataset laid out by the policy, opened with the given access properties. h5::create is not used, as it
+ * cannot tell property lists passed as h5::dcpl_t and h5::dapl_t apart.
+ */
+template <typename T>
+auto create_dataset(const h5::fd_t &fd, const std::string &name, const std::vector<size_t> &dims, const StoragePolicy &policy,
+                    bool fill_zero, const h5::dapl_t &dapl = h5::default_dapl) -> h5::ds_t {
+    const T zero{0};
+    h5::dt_t<T> type;
+    const h5::dcpl_t dcpl = dataset_creation(policy, dims, sizeof(T), type, fill_zero ? &zero : nullptr);
+
+    const std::vector<hsize_t> extents(dims.begin(), dims.end());
+    h5::sp_t space{H5Screate_simple(static_cast<int>(extents.size()), extents.data(), nullptr)};
+    return h5::createds(fd, name, type, space, h5::default_lcpl, dcpl, dapl);
+}
+
+} // namespace detail
+
+} // namespace einsums
@@ -0,0 +1,251 @@
+#pragma once
+
+#include "einsums/OpenMP.h"
+#include "einsums/Section.hpp"
+#include "einsums/Tensor.hpp"
+#include "einsums/TensorAlgebra.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace einsums {
+
+/**
+ * Permutational symmetry of a four-index tensor (pq|rs).
+ *
+ * FourFold: (pq|rs) = (qp|rs) = (pq|sr) = (qp|sr).
+ * EightFold: in addition (pq|rs) = (rs|pq), as for real two-electron integrals.
+ */
+enum class Symmetry { FourFold, EightFold };
+
+/**
+ * Four-index tensor of dimension n stored with only its symmetry-unique elements.
+ *
+ * The index pairs pq and rs are packed into lower-triangular pair indices, pq = p(p+1)/2 + q for p >= q. FourFold stores
+ * the full pair matrix [pq][rs], EightFold only its lower triangle. Every permutation of an element refers to the same
+ * storage, so writing (pq|rs) also writes (qp|sr), and so on.
+ *
+ * A SymmetricTensor takes part in einsum as either operand; it is unpacked slab by slab into a dense tensor on the way.
+ */
+template <typename T>
+struct SymmetricTensor {
+    using vector = std::vector<T, AlignedAllocator<T, 64>>;
+
+    SymmetricTensor() = default;
+
+    SymmetricTensor(std::string name, size_t n, Symmetry symmetry = Symmetry::EightFold)
+        : _name{std::move(name)}, _n{n}, _symmetry{symmetry}, _data(packed_size(n, symmetry)) {}
+
+    /// Packs a dense tensor that has the given symmetry. Only the elements with p >= q, r >= s (and pq >= rs) are read.
+    SymmetricTensor(const Tensor<T, 4> &dense, Symmetry symmetry = Symmetry::EightFold)
+        : SymmetricTensor(dense.name(), dense.dim(0), symmetry) {
+        const Dim<4> dims = dense.dims();
+        if (dims[1] != _n || dims[2] != _n || dims[3] != _n)
+            throw std::runtime_error("SymmetricTensor: all four dimensions of the dense tensor must be the same");
+
+        const size_t pairs = _n * (_n + 1) / 2;
+#pragma omp parallel for
+        for (size_t p = 0; p < _n; p++) {
+            for (size_t q = 0; q <= p; q++) {
+                const size_t pq = pair(p, q);
+                for (size_t r = 0; r < _n; r++) {
+                    for (size_t s = 0; s <= r; s++) {
+                        const size_t rs = pair(r, s);
+                        if (_symmetry == Symmetry::EightFold && rs > pq)
+                            break;
+                        _data[_symmetry == Symmetry::EightFold ? pair(pq, rs) : pq * pairs + rs] = dense(p, q, r, s);
+                    }
+                }
+            }
+        }
+    }
+
+    /// Number of elements stored for a tensor of dimension n.
+    static auto packed_size(size_t n, Symmetry symmetry) -> size_t {
+        const size_t pairs = n * (n + 1) / 2;
+        return symmetry == Symmetry::EightFold ? pairs * (pairs + 1) / 2 : pairs * pairs;
+    }
+
+    /// Packed index of an unordered pair.
+    static auto pair(size_t p, size_t q) -> size_t { return p >= q ? p * (p + 1) / 2 + q : q * (q + 1) / 2 + p; }
+
+    /// Offset of (pq|rs) in the packed storage.
+    [[nodiscard]] auto offset(size_t p, size_t q, size_t r, size_t s) const -> size_t {
+        const size_t pq = pair(p, q), rs = pair(r, s);
+        return _symmetry == Symmetry::EightFold ? pair(pq, rs) : pq * (_n * (_n + 1) / 2) + rs;
+    }
+
+    auto operator()(size_t p, size_t q, size_t r, size_t s) -> T & { return _data[offset(p, q, r, s)]; }
+    auto operator()(size_t p, size_t q, size_t r, size_t s) const -> const T & { return _data[offset(p, q, r, s)]; }
+
+    /**
+     * Writes the elements of the dense block at the given offset into block, which may be a Tensor or a TensorView. The
+     * pair index of the first two indices is computed once per (p, q) and that of the last two once per element.
+     */
+    template <template <typename, size_t> typename BlockType>
+    void unpack_block(const Offset<4> &at, BlockType<T, 4> *block) const {
+        const Dim<4> dims = block->dims();
+        for (size_t d = 0; d < 4; d++) {
+            if (at[d] + dims[d] > _n)
+                throw std::runtime_error("SymmetricTensor::unpack_block: block extends past the end of " + _name);
+        }
+
+        const size_t pairs = _n * (_n + 1) / 2;
+        T *out = block->data();
+        const size_t s0 = block->stride(0), s1 = block->stride(1), s2 = block->stride(2), s3 = block->stride(3);
+        const T *data = _data.data();
+
+#pragma omp parallel for collapse(2)
+        for (size_t i = 0; i < dims[0]; i++) {
+            for (size_t j = 0; j < dims[1]; j++) {
+                const size_t pq = pair(at[0] + i, at[1] + j);
+                for (size_t k = 0; k < dims[2]; k++) {
+                    T *row = out + i * s0 + j * s1 + k * s2;
+                    const size_t r = at[2] + k;
+                    for (size_t l = 0; l < dims[3]; l++) {
+                        const size_t rs = pair(r, at[3] + l);
+                        row[l * s3] = data[_symmetry == Symmetry::EightFold ? pair(pq, rs) : pq * pairs + rs];
+                    }
+                }
+            }
+        }
+    }
+
+    /// The whole tensor, unpacked.
+    [[nodiscard]] auto unpack() const -> Tensor<T, 4> {
+        Tensor<T, 4> dense{_name, _n, _n, _n, _n};
+        unpack_block(Offset<4>{0, 0, 0, 0}, &dense);
+        return dense;
+    }
+
+    void zero() { std::fill(_data.begin(), _data.end(), T{0}); }
+    void set_all(T value) { std::fill(_data.begin(), _data.end(), value); }
+
+    [[nodiscard]] auto dim(int /*d*/) const -> size_t { return _n; }
+    [[nodiscard]] auto dims() const -> Dim<4> { return Dim<4>{_n, _n, _n, _n}; }
+    [[nodiscard]] auto symmetry() const -> Symmetry { return _symmetry; }
+
+    /// Number of elements stored.
+    [[nodiscard]] auto size() const -> size_t { return _data.size(); }
+
+    auto data() -> T * { return _data.data(); }
+    [[nodiscard]] auto data() const -> const T * { return _data.data(); }
+
+    [[nodiscard]] auto name() const -> const std::string & { return _name; }
+    void set_name(const std::string &name) { _name = name; }
+
+  private:
+    std::string _name{"(Unnamed)"};
+    size_t _n{0};
+    Symmetry _symmetry{Symmetry::EightFold};
+    vector _data;
+};
+
+namespace tensor_algebra {
+
+namespace detail {
+
+/// View of X restricted to count values of its index at Position, starting from first.
+template <size_t Position, template <typename, size_t> typename XType, typename T, size_t Rank>
+auto slab_view(XType<T, Rank> &X, size_t first, size_t count) -> TensorView<T, Rank> {
+    Dim<Rank> dims = X.dims();
+    Offset<Rank> offset{};
+    dims[Position] = count;
+    offset[Position] = first;
+    return TensorView<T, Rank>{X, dims, offset};
+}
+
+} // namespace detail
+
+/**
+ * C = C_prefactor * C + AB_prefactor * A * B with A symmetric. A is unpacked into a dense slab of consecutive values of
+ * its first index, sized so the slab holds no more elements than A itself, and each slab is contracted by the dense
+ * einsum against the matching part of C and B. Peak memory is therefore at most twice the packed size of A.
+ */
+template <typename T, template <typename, size_t> typename CType, size_t CRank, template <typename, size_t> typename BType, size_t BRank,
+          typename... CIndices, typename... AIndices, typename... BIndices, typename U>
+auto einsum(const U UC_prefactor, const std::tuple<CIndices...> &C_indices, CType<T, CRank> *C, const U UAB_prefactor,
+            const std::tuple<AIndices...> &A_indices, const SymmetricTensor<T> &A, const std::tuple<BIndices...> &B_indices,
+            const BType<T, BRank> &B)
+    -> std::enable_if_t<std::is_base_of_v<::einsums::detail::TensorBase<T, CRank>, CType<T, CRank>> &&
+                        std::is_base_of_v<::einsums::detail::TensorBase<T, BRank>, BType<T, BRank>> && std::is_arithmetic_v<U>> {
+    static_assert(sizeof...(AIndices) == 4, "A symmetric tensor takes four indices.");
+    using First = std::tuple_element_t<0, std::tuple<AIndices...>>;
+    static_assert((std::is_same_v<std::decay_t<First>, std::decay_t<AIndices>> + ...) == 1,
+                  "The first index of a symmetric tensor may not be repeated.");
+    constexpr int in_C = detail::find_position<First, CIndices...>();
+    constexpr int in_B = detail::find_position<First, BIndices...>();
+
+    Section section{fmt::format("einsum: symmetric {}", A.name())};
+
+    const T C_prefactor = UC_prefactor;
+    const T AB_prefactor = UAB_prefactor;
+    const size_t n = A.dim(0);
+    const size_t rows = std::clamp<size_t>(A.size() / std::max<size_t>(1, n * n * n), 1, std::max<size_t>(1, n));
+
+    Tensor<T, 4> slab{A.name() + " (unpacked)", rows, n, n, n};
+
+    for (size_t first = 0; first < n; first += rows) {
+        const size_t count = std::min(rows, n - first);
+        TensorView<T, 4> block{slab, Dim<4>{count, n, n, n}};
+        block.set_name(slab.name());
+        A.unpack_block(Offset<4>{first, 0, 0, 0}, &block);
+
+        // C and B are restricted to the slab where they share its first index. When the first index is summed over, C
+        // keeps its prefactor only for the first slab.
+        const T slab_C_prefactor = in_C >= 0 || first == 0 ? C_prefactor : T{1};
+
+        if constexpr (in_C >= 0 && in_B >= 0) {
+            auto Cv = detail::slab_view<in_C>(*C, first, count);
+            const auto Bv = detail::slab_view<in_B>(const_cast<BType<T, BRank> &>(B), first, count);
+            einsum(slab_C_prefactor, C_indices, &Cv, AB_prefactor, A_indices, block, B_indices, Bv);
+        } else if constexpr (in_C >= 0) {
+            auto Cv = detail::slab_view<in_C>(*C, first, count);
+            einsum(slab_C_prefactor, C_indices, &Cv, AB_prefactor, A_indices, block, B_indices, B);
+        } else if constexpr (in_B >= 0) {
+            const auto Bv = detail::slab_view<in_B>(const_cast<BType<T, BRank> &>(B), first, count);
+            einsum(slab_C_prefactor, C_indices, C, AB_prefactor, A_indices, block, B_indices, Bv);
+        } else {
+            einsum(slab_C_prefactor, C_indices, C, AB_prefactor, A_indices, block, B_indices, B);
+        }
+    }
+}
+
+/// C = C_prefactor * C + AB_prefactor * A * B with B symmetric.
+template <typename T, template <typename, size_t> typename CType, size_t CRank, template <typename, size_t> typename AType, size_t ARank,
+          typename... CIndices, typename... AIndices, typename... BIndices, typename U>
+auto einsum(const U UC_prefactor, const std::tuple<CIndices...> &C_indices, CType<T, CRank> *C, const U UAB_prefactor,
+            const std::tuple<AIndices...> &A_indices, const AType<T, ARank> &A, const std::tuple<BIndices...> &B_indices,
+            const SymmetricTensor<T> &B)
+    -> std::enable_if_t<std::is_base_of_v<::einsums::detail::TensorBase<T, CRank>, CType<T, CRank>> &&
+                        std::is_base_of_v<::einsums::detail::TensorBase<T, ARank>, AType<T, ARank>> && std::is_arithmetic_v<U>> {
+    einsum(UC_prefactor, C_indices, C, UAB_prefactor, B_indices, B, A_indices, A);
+}
+
+template <typename T, template <typename, size_t> typename CType, size_t CRank, template <typename, size_t> typename BType, size_t BRank,
+          typename... CIndices, typename... AIndices, typename... BIndices>
+auto einsum(const std::tuple<CIndices...> &C_indices, CType<T, CRank> *C, const std::tuple<AIndices...> &A_indices,
+            const SymmetricTensor<T> &A, const std::tuple<BIndices...> &B_indices, const BType<T, BRank> &B)
+    -> std::enable_if_t<std::is_base_of_v<::einsums::detail::TensorBase<T, CRank>, CType<T, CRank>> &&
+                        std::is_base_of_v<::einsums::detail::TensorBase<T, BRank>, BType<T, BRank>>> {
+    einsum(0, C_indices, C, 1, A_indices, A, B_indices, B);
+}
+
+template <typename T, template <typename, size_t> typename CType, size_t CRank, template <typename, size_t> typename AType, size_t ARank,
+          typename... CIndices, typename... AIndices, typename... BIndices>
+auto einsum(const std::tuple<CIndices...> &C_indices, CType<T, CRank> *C, const std::tuple<AIndices...> &A_indices,
+            const AType<T, ARank> &A, const std::tuple<BIndices...> &B_indices, const SymmetricTensor<T> &B)
+    -> std::enable_if_t<std::is_base_of_v<::einsums::detail::TensorBase<T, CRank>, CType<T, CRank>> &&
+                        std::is_base_of_v<::einsums::detail::TensorBase<T, ARank>, AType<T, ARank>>> {
+    einsum(0, C_indices, C, 1, B_indices, B, A_indices, A);
+}
+
+} // namespace tensor_algebra
+
+} // namespace einsums
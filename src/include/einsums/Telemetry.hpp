@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Record of the algorithm each einsum call ran and how fast it ran, to find the contractions worth rewriting. einsum
+// only records its calls in builds configured with EINSUMS_TELEMETRY.
+namespace einsums::telemetry {
+
+/// Totals for the calls of one call site: the same contraction, on the same dims, through the same algorithm.
+struct Entry {
+    std::string signature;
+    std::string dims;
+    std::string algorithm;
+    size_t calls{0};
+    double flops{0};
+    double bytes{0};
+    double seconds{0};
+};
+
+/// Entries recorded so far, the most time consuming first.
+auto entries() -> std::vector<Entry>;
+
+void clear();
+
+/// Prints the entries with their GFLOP/s, followed by the share of the einsum time spent in the fallback algorithms.
+void report();
+
+/// Writes the entries as a JSON array. Throws std::runtime_error if the file cannot be opened.
+void dump_json(const std::string &filename);
+
+/// Algorithms that einsum only uses when no BLAS call fits the contraction.
+auto is_fallback(const std::string &algorithm) -> bool;
+
+namespace detail {
+
+/**
+ * Measures one einsum call from construction to destruction and adds it to the entries. The dispatcher names the
+ * algorithm it runs through set_algorithm. Calls nest: set_algorithm applies to the innermost call on the thread.
+ */
+struct Call {
+    Call(std::string signature, std::string dims, double flops, double bytes);
+    ~Call();
+
+    Call(const Call &) = delete;
+    auto operator=(const Call &) -> Call & = delete;
+
+    std::string signature;
+    std::string dims;
+    const char *algorithm{"unknown"};
+    double flops;
+    double bytes;
+
+  private:
+    Call *_previous;
+    std::chrono::steady_clock::time_point _start;
+};
+
+extern thread_local Call *current_call;
+
+/// Names the algorithm of the innermost call on this thread. Does nothing outside of a Call.
+inline void set_algorithm(const char *algorithm) {
+    if (current_call != nullptr)
+        current_call->algorithm = algorithm;
+}
+
+} // namespace detail
+
+} // namespace einsums::telemetry
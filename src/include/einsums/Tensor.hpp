@@ -1,10 +1,14 @@
 #pragma once
 
+#include "einsums/AsyncIO.hpp"
 #include "einsums/OpenMP.h"
 #include "einsums/Print.hpp"
 #include "einsums/STL.hpp"
 #include "einsums/State.hpp"
+#include "einsums/StoragePolicy.hpp"
 #include "einsums/_Common.hpp"
+#include "einsums/_LoopNest.hpp"
+#include "einsums/_TensorExpression.hpp"
 
 // Include headers from the ranges library that we need to handle cartesian_products
 #include "range/v3/range_fwd.hpp"
@@ -18,6 +22,7 @@
 #include <array>
 #include <cassert>
 #include <chrono>
+#include <deque>
 #include <exception>
 #include <functional>
 #include <iomanip>
@@ -50,6 +55,9 @@ struct TensorView;
 template <typename T, size_t ViewRank, size_t Rank>
 struct DiskView;
 
+template <typename T, size_t ViewRank, size_t Rank>
+struct AsyncDiskView;
+
 template <typename T, size_t Rank>
 struct DiskTensor;
 
@@ -60,14 +68,6 @@ auto get_dim_ranges(const TensorType<T, Rank> &tensor, std::index_sequence<I...>
     return std::tuple{ranges::views::ints(0, (int)tensor.dim(I))...};
 }
 
-template <size_t N, typename Target, typename Source1, typename Source2>
-void add_elements(Target &target, const Source1 &source1, const Source2 &source2) {
-    if constexpr (N > 1) {
-        add_elements<N - 1>(target, source1, source2);
-    }
-    target[N - 1] = source1[N - 1] + std::get<N - 1>(source2);
-}
-
 } // namespace detail
 
 template <int N, template <typename, size_t> typename TensorType, size_t Rank, typename T>
@@ -199,12 +199,16 @@ struct Tensor final : public detail::TensorBase<T, Rank> {
         // Resize the data structure
         _data.resize(size);
 
-        auto target_dims = get_dim_ranges<Rank>(*this);
-        for (auto target_combination : std::apply(ranges::views::cartesian_product, target_dims)) {
-            T &target_value = std::apply(*this, target_combination);
-            T value = std::apply(other, target_combination);
-            target_value = value;
-        }
+        auto nest = detail::make_loop_nest(*this, other);
+        T *target = data();
+        const T *source = other.data();
+        nest.parallel_for_each([&](const std::array<size_t, 2> &offset) { target[offset[0]] = source[offset[1]]; });
+    }
+
+    /// Evaluates a lazy element-wise expression into a new tensor with the dims of the expression.
+    template <typename Derived>
+    Tensor(const TensorExpression<Derived> &expression) : Tensor(expression.self().dims()) {
+        detail::evaluate_expression(*this, expression.self(), detail::AssignElement{});
     }
 
     void zero() {
@@ -401,12 +405,10 @@ struct Tensor final : public detail::TensorBase<T, Rank> {
         if constexpr (std::is_same_v<T, TOther>) {
             std::copy(other._data.begin(), other._data.end(), _data.begin());
         } else {
-            auto target_dims = get_dim_ranges<Rank>(*this);
-            for (auto target_combination : std::apply(ranges::views::cartesian_product, target_dims)) {
-                T &target_value = std::apply(*this, target_combination);
-                T value = std::apply(other, target_combination);
-                target_value = value;
-            }
+            auto nest = detail::make_loop_nest(*this, other);
+            T *target = data();
+            const TOther *source = other.data();
+            nest.parallel_for_each([&](const std::array<size_t, 2> &offset) { target[offset[0]] = source[offset[1]]; });
         }
 
         return *this;
@@ -414,13 +416,32 @@ struct Tensor final : public detail::TensorBase<T, Rank> {
 
     template <typename TOther>
     auto operator=(const TensorView<TOther, Rank> &other) -> Tensor<T, Rank> & {
-        auto target_dims = get_dim_ranges<Rank>(*this);
-        for (auto target_combination : std::apply(ranges::views::cartesian_product, target_dims)) {
-            T &target_value = std::apply(*this, target_combination);
-            T value = std::apply(other, target_combination);
-            target_value = value;
-        }
+        auto nest = detail::make_loop_nest(*this, other);
+        T *target = data();
+        const TOther *source = other.data();
+        nest.parallel_for_each([&](const std::array<size_t, 2> &offset) { target[offset[0]] = source[offset[1]]; });
+
+        return *this;
+    }
+
+    /// Evaluates a lazy element-wise expression in a single pass. An empty tensor is first sized to the expression.
+    template <typename Derived>
+    auto operator=(const TensorExpression<Derived> &expression) -> Tensor<T, Rank> & {
+        if (size() == 0)
+            *this = Tensor<T, Rank>(expression.self().dims());
+        detail::evaluate_expression(*this, expression.self(), detail::AssignElement{});
+        return *this;
+    }
+
+    template <typename Derived>
+    auto operator+=(const TensorExpression<Derived> &expression) -> Tensor<T, Rank> & {
+        detail::evaluate_expression(*this, expression.self(), detail::AddElement{});
+        return *this;
+    }
 
+    template <typename Derived>
+    auto operator-=(const TensorExpression<Derived> &expression) -> Tensor<T, Rank> & {
+        detail::evaluate_expression(*this, expression.self(), detail::SubtractElement{});
         return *this;
     }
 
@@ -529,6 +550,9 @@ struct Tensor<double, 0> : public detail::TensorBase<double, 0> {
 
     operator double() const { return _data; }
 
+    auto operator()() -> double & { return _data; }
+    [[nodiscard]] auto operator()() const -> const double & { return _data; }
+
     [[nodiscard]] auto name() const -> const std::string & { return _name; }
     void set_name(const std::string &name) { _name = name; }
 
@@ -536,6 +560,8 @@ struct Tensor<double, 0> : public detail::TensorBase<double, 0> {
 
     [[nodiscard]] auto dims() const -> Dim<0> { return Dim<0>{}; }
 
+    [[nodiscard]] auto stride(int) const -> size_t { return 1; }
+
     [[nodiscard]] auto full_view_of_underlying() const noexcept -> bool { return true; }
 
   private:
@@ -593,14 +619,14 @@ struct TensorView final : public detail::TensorBase<T, Rank> {
         // Can't perform checks on data. Assume the user knows what they're doing.
         // This function is used when interfacing with libint2.
 
-        auto target_dims = get_dim_ranges<Rank>(*this);
-        size_t item{0};
-
-        for (auto target_combination : std::apply(ranges::views::cartesian_product, target_dims)) {
-            T &target = std::apply(*this, target_combination);
-            target = other[item];
-            item++;
+        // The loop nest walks the view in row-major order, so the second operand is simply the packed ordinal.
+        auto nest = detail::make_loop_nest(*this);
+        size_t packed_stride{1};
+        for (size_t d = Rank; d-- > 0;) {
+            nest.steps[d] = {stride(d), packed_stride};
+            packed_stride *= dim(d);
         }
+        nest_assign(nest, other);
 
         return *this;
     }
@@ -613,14 +639,7 @@ struct TensorView final : public detail::TensorBase<T, Rank> {
                 return *this;
         }
 
-        auto target_dims = get_dim_ranges<Rank>(*this);
-        auto view = std::apply(ranges::views::cartesian_product, target_dims);
-
-#pragma omp parallel for
-        for (auto target_combination = view.begin(); target_combination != view.end(); target_combination++) {
-            T &target = std::apply(*this, *target_combination);
-            target = std::apply(other, *target_combination);
-        }
+        nest_assign(detail::make_loop_nest(*this, other), other.data());
 
         return *this;
     }
@@ -633,41 +652,41 @@ struct TensorView final : public detail::TensorBase<T, Rank> {
                 return *this;
         }
 
-        auto target_dims = get_dim_ranges<Rank>(*this);
-        auto view = std::apply(ranges::views::cartesian_product, target_dims);
-
-#pragma omp parallel for
-        for (auto target_combination = view.begin(); target_combination != view.end(); target_combination++) {
-            T &target = std::apply(*this, *target_combination);
-            target = std::apply(other, *target_combination);
-        }
+        nest_assign(detail::make_loop_nest(*this, other), other.data());
 
         return *this;
     }
 
     auto operator=(const T &fill_value) -> TensorView & {
-        auto target_dims = get_dim_ranges<Rank>(*this);
-        auto view = std::apply(ranges::views::cartesian_product, target_dims);
-
-#pragma omp parallel for
-        for (auto target_combination = view.begin(); target_combination != view.end(); target_combination++) {
-            T &target = std::apply(*this, *target_combination);
-            target = fill_value;
-        }
+        T *target = data();
+        detail::make_loop_nest(*this).parallel_for_each([&](const std::array<size_t, 1> &offset) { target[offset[0]] = fill_value; });
 
         return *this;
     }
 
     auto operator/=(const T &value) -> TensorView & {
-        auto target_dims = get_dim_ranges<Rank>(*this);
-        auto view = std::apply(ranges::views::cartesian_product, target_dims);
+        T *target = data();
+        detail::make_loop_nest(*this).parallel_for_each([&](const std::array<size_t, 1> &offset) { target[offset[0]] /= value; });
 
-#pragma omp parallel for
-        for (auto target_combination = view.begin(); target_combination != view.end(); target_combination++) {
-            T &target = std::apply(*this, *target_combination);
-            target /= value;
-        }
+        return *this;
+    }
+
+    /// Evaluates a lazy element-wise expression into the elements of the view in a single pass.
+    template <typename Derived>
+    auto operator=(const TensorExpression<Derived> &expression) -> TensorView & {
+        detail::evaluate_expression(*this, expression.self(), detail::AssignElement{});
+        return *this;
+    }
 
+    template <typename Derived>
+    auto operator+=(const TensorExpression<Derived> &expression) -> TensorView & {
+        detail::evaluate_expression(*this, expression.self(), detail::AddElement{});
+        return *this;
+    }
+
+    template <typename Derived>
+    auto operator-=(const TensorExpression<Derived> &expression) -> TensorView & {
+        detail::evaluate_expression(*this, expression.self(), detail::SubtractElement{});
         return *this;
     }
 
@@ -756,6 +775,12 @@ struct TensorView final : public detail::TensorBase<T, Rank> {
     }
 
   private:
+    /// Copies source into the view. The second operand of the loop nest gives the offsets into source.
+    void nest_assign(const detail::LoopNest<Rank, 2> &nest, const T *source) {
+        T *target = data();
+        nest.parallel_for_each([&](const std::array<size_t, 2> &offset) { target[offset[0]] = source[offset[1]]; });
+    }
+
     auto common_initialization(const T *other) {
         _data = const_cast<T *>(other);
 
@@ -905,56 +930,72 @@ void write(const h5::fd_t &fd, const Tensor<T, 0> &ref) {
 
 template <size_t Rank, typename T, class... Args>
 void write(const h5::fd_t &fd, const TensorView<T, Rank> &ref, Args &&...args) {
-    h5::count count_default{1, 1, 1, 1, 1, 1, 1};
     h5::offset offset_default{0, 0, 0, 0, 0, 0, 0};
     h5::stride stride_default{1, 1, 1, 1, 1, 1, 1};
-    h5::offset view_offset{0, 0, 0, 0, 0, 0, 0};
-    h5::offset disk_offset{0, 0, 0, 0, 0, 0, 0};
 
-    count_default.rank = Rank;
     offset_default.rank = Rank;
     stride_default.rank = Rank;
-    view_offset.rank = Rank;
-    disk_offset.rank = Rank;
-
-    if (ref.stride(Rank - 1) != 1) {
-        throw std::runtime_error("Final dimension of TensorView must be contiguous to write.");
-    }
 
     const h5::offset &offset = h5::arg::get(offset_default, args...);
     const h5::stride &stride = h5::arg::get(stride_default, args...);
 
-    count_default[Rank - 1] = ref.dim(Rank - 1);
-
     // Does the entry exist on disk?
     h5::ds_t ds;
-    if (H5Lexists(state::data, ref.name().c_str(), H5P_DEFAULT) > 0) {
+    if (H5Lexists(fd, ref.name().c_str(), H5P_DEFAULT) > 0) {
         ds = h5::open(fd, ref.name().c_str());
     } else {
-        std::array<size_t, Rank> chunk_temp{};
-        for (int i = 0; i < Rank; i++) {
-            if (ref.dim(i) < 10)
-                chunk_temp[i] = ref.dim(i);
-            else
-                chunk_temp[i] = 10;
-        }
-
-        ds = h5::create<T>(fd, ref.name().c_str(), h5::current_dims{ref.dims()},
-                           h5::chunk{chunk_temp} | h5::gzip{9} | h5::fill_value<T>(0.0));
-    }
-
-    auto dims = get_dim_ranges<Rank - 1>(ref);
-
-    for (auto combination : std::apply(ranges::views::cartesian_product, dims)) {
-        // We generate all the cartesian products for all the dimensions except the final dimension
-        // We call write on that final dimension.
-        detail::add_elements<Rank - 1>(view_offset, offset_default, combination);
-        detail::add_elements<Rank - 1>(disk_offset, offset, combination);
-
-        // Get the data pointer from the view
-        T *data = ref.data_array(view_offset);
-        h5::write<T>(ds, data, count_default, disk_offset);
-    }
+        const Dim<Rank> dims = ref.dims();
+        ds = detail::create_dataset<T>(fd, ref.name(), {dims.begin(), dims.end()}, default_storage_policy, true);
+    }
+
+    std::array<hsize_t, Rank> file_start{}, file_stride{}, count{};
+    for (size_t d = 0; d < Rank; d++) {
+        file_start[d] = offset[d];
+        file_stride[d] = stride[d];
+        count[d] = ref.dim(d);
+    }
+    if (std::find(count.begin(), count.end(), 0) != count.end())
+        return;
+
+    // In memory the view is a dataspace with one more index than the view. Its extents are the ratios of successive
+    // strides, and the extra index steps over the elements between two along the last index. Views whose strides do
+    // not nest that way are packed first. Either way HDF5 writes the view in one call.
+    std::array<hsize_t, Rank + 1> memory_dims{}, memory_count{};
+    bool nested = ref.stride(Rank - 1) != 0;
+    for (size_t d = 0; d < Rank && nested; d++) {
+        memory_count[d] = count[d];
+        if (d == 0)
+            memory_dims[d] = count[d];
+        else if (ref.stride(d) != 0 && ref.stride(d - 1) % ref.stride(d) == 0 && ref.stride(d - 1) / ref.stride(d) >= count[d])
+            memory_dims[d] = ref.stride(d - 1) / ref.stride(d);
+        else
+            nested = false;
+    }
+    memory_dims[Rank] = ref.stride(Rank - 1);
+    memory_count[Rank] = 1;
+
+    const T *source = ref.data();
+    std::unique_ptr<Tensor<T, Rank>> packed;
+    if (!nested) {
+        packed = std::make_unique<Tensor<T, Rank>>(ref);
+        source = packed->data();
+        std::copy(count.begin(), count.end(), memory_dims.begin());
+        std::copy(count.begin(), count.end(), memory_count.begin());
+        memory_dims[Rank] = 1;
+    }
+
+    h5::sp_t file_space{H5Dget_space(ds)};
+    if (H5Sselect_hyperslab(file_space, H5S_SELECT_SET, file_start.data(), file_stride.data(), count.data(), nullptr) < 0)
+        throw std::runtime_error(fmt::format("write: unable to select the hyperslab of {} on disk", ref.name()));
+
+    const std::array<hsize_t, Rank + 1> memory_start{};
+    h5::sp_t memory_space{H5Screate_simple(Rank + 1, memory_dims.data(), nullptr)};
+    if (H5Sselect_hyperslab(memory_space, H5S_SELECT_SET, memory_start.data(), nullptr, memory_count.data(), nullptr) < 0)
+        throw std::runtime_error(fmt::format("write: unable to select {} in memory", ref.name()));
+
+    h5::dt_t<T> type;
+    if (H5Dwrite(ds, type, memory_space, file_space, H5P_DEFAULT, source) < 0)
+        throw std::runtime_error(fmt::format("write: unable to write {}", ref.name()));
 }
 
 // This needs to be expanded to handle the various h5 parameters like above.
@@ -989,6 +1030,13 @@ void zero(Tensor<T, Rank> &A) {
     A.zero();
 }
 
+/**
+ * How a view of a DiskTensor uses its slab. Read reads it and never writes it back. WriteDiscard skips the read, as the
+ * caller overwrites every element. ReadWrite reads it and writes it back. Views write back only once they have been
+ * changed through a non-const accessor.
+ */
+enum class Access { Read, WriteDiscard, ReadWrite };
+
 template <typename T, size_t Rank>
 struct DiskTensor final : public detail::TensorBase<T, Rank> {
     DiskTensor() = default;
@@ -998,7 +1046,12 @@ struct DiskTensor final : public detail::TensorBase<T, Rank> {
 
     template <typename... Dims>
     explicit DiskTensor(h5::fd_t &file, std::string name, Dims... dims)
-        : _file{file}, _name{std::move(name)}, _dims{static_cast<size_t>(dims)...} {
+        : DiskTensor(file, std::move(name), default_storage_policy, dims...) {}
+
+    /// Creates or opens the tensor with the given chunking, compression and chunk cache.
+    template <typename... Dims>
+    explicit DiskTensor(h5::fd_t &file, std::string name, const StoragePolicy &policy, Dims... dims)
+        : _file{file}, _name{std::move(name)}, _dims{static_cast<size_t>(dims)...}, _access(detail::dataset_access(policy)) {
         static_assert(Rank == sizeof...(dims), "Declared Rank does not match provided dims");
 
         struct stride {
@@ -1014,19 +1067,11 @@ struct DiskTensor final : public detail::TensorBase<T, Rank> {
         // Row-major order of dimensions
         std::transform(_dims.rbegin(), _dims.rend(), _strides.rbegin(), stride());
 
-        std::array<size_t, Rank> chunk_temp{};
-        for (int i = 0; i < Rank; i++) {
-            if (_dims[i] < 10)
-                chunk_temp[i] = _dims[i];
-            else
-                chunk_temp[i] = 64;
-        }
-
         // Check to see if the data set exists
         if (H5Lexists(_file, _name.c_str(), H5P_DEFAULT) > 0) {
             _existed = true;
             try {
-                _disk = h5::open(_file, _name);
+                _disk = h5::open(_file, _name, _access);
             } catch (std::exception &e) {
                 println("Unable to open disk tensor '{}'", _name);
                 std::abort();
@@ -1035,8 +1080,7 @@ struct DiskTensor final : public detail::TensorBase<T, Rank> {
             _existed = false;
             // Use h5cpp create data structure on disk.  Refrain from allocating any memory
             try {
-                _disk = h5::create<T>(_file, _name, h5::current_dims{static_cast<size_t>(dims)...},
-                                      h5::chunk{chunk_temp} | h5::gzip{9} /* | h5::fill_value<T>(0.0) */);
+                _disk = detail::create_dataset<T>(_file, _name, {_dims.begin(), _dims.end()}, policy, false, _access);
             } catch (std::exception &e) {
                 println("Unable to create disk tensor '{}'", _name);
                 std::abort();
@@ -1046,12 +1090,11 @@ struct DiskTensor final : public detail::TensorBase<T, Rank> {
 
     // Constructs a DiskTensor shaped like the provided Tensor. Data from the provided tensor
     // is NOT saved.
-    explicit DiskTensor(h5::fd_t &file, const Tensor<T, Rank> &tensor) : _file{file}, _name{tensor.name()} {
+    explicit DiskTensor(h5::fd_t &file, const Tensor<T, Rank> &tensor, const StoragePolicy &policy = default_storage_policy)
+        : _file{file}, _name{tensor.name()}, _access(detail::dataset_access(policy)) {
         // Save dimension information from the provided tensor.
-        h5::current_dims cdims;
         for (int i = 0; i < Rank; i++) {
             _dims[i] = tensor.dim(i);
-            cdims[i] = _dims[i];
         }
 
         struct stride {
@@ -1067,19 +1110,11 @@ struct DiskTensor final : public detail::TensorBase<T, Rank> {
         // Row-major order of dimensions
         std::transform(_dims.rbegin(), _dims.rend(), _strides.rbegin(), stride());
 
-        std::array<size_t, Rank> chunk_temp{};
-        for (int i = 0; i < Rank; i++) {
-            if (_dims[i] < 10)
-                chunk_temp[i] = _dims[i];
-            else
-                chunk_temp[i] = 64;
-        }
-
         // Check to see if the data set exists
         if (H5Lexists(_file, _name.c_str(), H5P_DEFAULT) > 0) {
             _existed = true;
             try {
-                _disk = h5::open(state::data, _name);
+                _disk = h5::open(state::data, _name, _access);
             } catch (std::exception &e) {
                 println("Unable to open disk tensor '%s'", _name.c_str());
                 std::abort();
@@ -1088,7 +1123,7 @@ struct DiskTensor final : public detail::TensorBase<T, Rank> {
             _existed = false;
             // Use h5cpp create data structure on disk.  Refrain from allocating any memory
             try {
-                _disk = h5::create<T>(_file, _name, cdims, h5::chunk{chunk_temp} | h5::gzip{9} | h5::fill_value<T>(0.0));
+                _disk = detail::create_dataset<T>(_file, _name, {_dims.begin(), _dims.end()}, policy, true, _access);
             } catch (std::exception &e) {
                 println("Unable to create disk tensor '%s'", _name.c_str());
                 std::abort();
@@ -1117,49 +1152,7 @@ struct DiskTensor final : public detail::TensorBase<T, Rank> {
     auto operator()(MultiIndex... index)
         -> std::enable_if_t<count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>() != 0,
                             DiskView<T, count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>(), Rank>> {
-        // Get positions of All
-        auto all_positions =
-            get_array_from_tuple<std::array<int, count_of_type<All_t, MultiIndex...>()>>(positions_of_type<All_t, MultiIndex...>());
-        auto index_positions =
-            get_array_from_tuple<std::array<int, count_of_type<size_t, MultiIndex...>()>>(positions_of_type<size_t, MultiIndex...>());
-        auto range_positions =
-            get_array_from_tuple<std::array<int, count_of_type<Range, MultiIndex...>()>>(positions_of_type<Range, MultiIndex...>());
-
-        const auto &indices = std::forward_as_tuple(index...);
-
-        // Need the offset and stride into the large tensor
-        Offset<Rank> offsets{};
-        Stride<Rank> strides{};
-        Count<Rank> counts{};
-
-        std::fill(counts.begin(), counts.end(), 1.0);
-
-        // Need the dim of the smaller tensor
-        Dim<count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>()> dims_all{};
-
-        for (auto [i, value] : enumerate(index_positions)) {
-            // printf("i, value: %d %d\n", i, value);
-            offsets[value] = get_from_tuple<size_t>(indices, value);
-        }
-        for (auto [i, value] : enumerate(all_positions)) {
-            // println("here");
-            strides[value] = _strides[value];
-            counts[value] = _dims[value];
-            // dims_all[i] = _dims[value];
-        }
-        for (auto [i, value] : enumerate(range_positions)) {
-            offsets[value] = get_from_tuple<Range>(indices, value)[0];
-            counts[value] = get_from_tuple<Range>(indices, value)[1] - get_from_tuple<Range>(indices, value)[0];
-        }
-
-        // Go through counts and anything that isn't equal to 1 is copied to the dims_all
-        int dims_index = 0;
-        for (auto cnt : counts) {
-            if (cnt > 1) {
-                dims_all[dims_index++] = cnt;
-            }
-        }
-
+        auto [dims_all, counts, offsets, strides] = slab(index...);
         return DiskView<T, count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>(), Rank>(*this, dims_all, counts,
                                                                                                                 offsets, strides);
     }
@@ -1168,6 +1161,53 @@ struct DiskTensor final : public detail::TensorBase<T, Rank> {
     auto operator()(MultiIndex... index) const
         -> std::enable_if_t<count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>() != 0,
                             const DiskView<T, count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>(), Rank>> {
+        auto [dims_all, counts, offsets, strides] = slab(index...);
+        return DiskView<T, count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>(), Rank>(*this, dims_all, counts,
+                                                                                                                offsets, strides);
+    }
+
+    // As operator(), with the given access to the slab.
+    template <typename... MultiIndex>
+    auto operator()(Access access, MultiIndex... index)
+        -> std::enable_if_t<count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>() != 0,
+                            DiskView<T, count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>(), Rank>> {
+        auto [dims_all, counts, offsets, strides] = slab(index...);
+        return DiskView<T, count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>(), Rank>(*this, dims_all, counts,
+                                                                                                                offsets, strides, access);
+    }
+
+    // As operator(), but the slab is read and written back by the I/O thread.
+    template <typename... MultiIndex>
+    auto async(MultiIndex... index)
+        -> std::enable_if_t<count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>() != 0,
+                            AsyncDiskView<T, count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>(), Rank>> {
+        auto [dims_all, counts, offsets, strides] = slab(index...);
+        return AsyncDiskView<T, count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>(), Rank>(
+            *this, dims_all, counts, offsets, strides);
+    }
+
+    template <typename... MultiIndex>
+    auto async(MultiIndex... index) const
+        -> std::enable_if_t<count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>() != 0,
+                            AsyncDiskView<T, count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>(), Rank>> {
+        auto [dims_all, counts, offsets, strides] = slab(index...);
+        return AsyncDiskView<T, count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>(), Rank>(
+            *this, dims_all, counts, offsets, strides);
+    }
+
+    template <typename... MultiIndex>
+    auto async(Access access, MultiIndex... index)
+        -> std::enable_if_t<count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>() != 0,
+                            AsyncDiskView<T, count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>(), Rank>> {
+        auto [dims_all, counts, offsets, strides] = slab(index...);
+        return AsyncDiskView<T, count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>(), Rank>(
+            *this, dims_all, counts, offsets, strides, access);
+    }
+
+  private:
+    // Dims of the view, and the counts, offsets and strides of its hyperslab, for a mix of indices, All and Ranges.
+    template <typename... MultiIndex>
+    auto slab(MultiIndex... index) const {
         // Get positions of All
         auto all_positions =
             get_array_from_tuple<std::array<int, count_of_type<All_t, MultiIndex...>()>>(positions_of_type<All_t, MultiIndex...>());
@@ -1211,17 +1251,18 @@ struct DiskTensor final : public detail::TensorBase<T, Rank> {
             }
         }
 
-        return DiskView<T, count_of_type<All_t, MultiIndex...>() + count_of_type<Range, MultiIndex...>(), Rank>(*this, dims_all, counts,
-                                                                                                                offsets, strides);
+        return std::make_tuple(dims_all, counts, offsets, strides);
     }
 
-  private:
     h5::fd_t &_file;
 
     std::string _name;
     Dim<Rank> _dims;
     Stride<Rank> _strides;
 
+    // Declared before _disk, which refers to it, so that it is closed after. Initialized with parentheses: braces would
+    // pick the initializer_list constructor of h5::dapl_t, which does not take a reference.
+    h5::dapl_t _access;
     h5::ds_t _disk;
 
     // Did the entry already exist on disk? Doesn't indicate validity of the data just the existance of the entry.
@@ -1231,9 +1272,11 @@ struct DiskTensor final : public detail::TensorBase<T, Rank> {
 template <typename T, size_t ViewRank, size_t Rank>
 struct DiskView final : public detail::TensorBase<T, ViewRank> {
     DiskView(DiskTensor<T, Rank> &parent, const Dim<ViewRank> &dims, const Count<Rank> &counts, const Offset<Rank> &offsets,
-             const Stride<Rank> &strides)
+             const Stride<Rank> &strides, Access access = Access::ReadWrite)
         : _parent(parent), _dims(dims), _counts(counts), _offsets(offsets), _strides(strides), _tensor{_dims} {
-        h5::read<T>(_parent.disk(), _tensor.data(), h5::count{_counts}, h5::offset{_offsets});
+        if (access != Access::WriteDiscard)
+            h5::read<T>(_parent.disk(), _tensor.data(), h5::count{_counts}, h5::offset{_offsets});
+        set_read_only(access == Access::Read);
     };
     DiskView(const DiskTensor<T, Rank> &parent, const Dim<ViewRank> &dims, const Count<Rank> &counts, const Offset<Rank> &offsets,
              const Stride<Rank> &strides)
@@ -1249,12 +1292,17 @@ struct DiskView final : public detail::TensorBase<T, ViewRank> {
 
     void set_read_only(bool readOnly) { _readOnly = readOnly; }
 
+    /// Whether the slab was changed since it was last read or written, so that put() would write it.
+    [[nodiscard]] auto dirty() const -> bool { return _dirty; }
+
     auto operator=(const T *other) -> DiskView & {
         // Can't perform checks on data. Assume the user knows what they're doing.
         // This function is used when interfacing with libint2.
 
-        // Save the data to disk.
+        // Save the data to disk, and keep the internal tensor in step so that it is not written back over it.
         h5::write<T>(_parent.disk(), other, h5::count{_counts}, h5::offset{_offsets});
+        std::copy(other, other + _tensor.size(), _tensor.data());
+        _dirty = false;
 
         return *this;
     }
@@ -1277,6 +1325,7 @@ struct DiskView final : public detail::TensorBase<T, ViewRank> {
         // Sync the data to disk and into our internal tensor.
         h5::write<T>(_parent.disk(), other.data(), h5::count{_counts}, h5::offset{_offsets});
         _tensor = other;
+        _dirty = false;
 
         return *this;
     }
@@ -1287,12 +1336,18 @@ struct DiskView final : public detail::TensorBase<T, ViewRank> {
         }
     }
 
-    // Does not perform a disk read. That was handled by the constructor.
-    auto get() -> Tensor<T, ViewRank> & { return _tensor; }
+    // Does not perform a disk read. That was handled by the constructor. The non-const overloads mark the slab dirty.
+    auto get() -> Tensor<T, ViewRank> & {
+        _dirty = true;
+        return _tensor;
+    }
+    auto get() const -> const Tensor<T, ViewRank> & { return _tensor; }
 
+    // Writes the slab back if it is dirty.
     void put() {
-        if (!_readOnly)
+        if (!_readOnly && _dirty)
             h5::write<T>(_parent.disk(), _tensor.data(), h5::count{_counts}, h5::offset{_offsets});
+        _dirty = false;
     }
 
     template <typename... MultiIndex>
@@ -1302,17 +1357,18 @@ struct DiskView final : public detail::TensorBase<T, ViewRank> {
 
     template <typename... MultiIndex>
     auto operator()(MultiIndex... index) -> T & {
+        _dirty = true;
         return _tensor(std::forward<MultiIndex>(index)...);
     }
 
     [[nodiscard]] auto dim(int d) const -> size_t { return _tensor.dim(d); }
     auto dims() const -> Dim<Rank> { return _tensor.dims(); }
 
-    operator Tensor<T, ViewRank> &() const { return _tensor; }
+    operator Tensor<T, ViewRank> &() { return get(); }
     operator const Tensor<T, ViewRank> &() const { return _tensor; }
 
-    void zero() { _tensor.zero(); }
-    void set_all(T value) { _tensor.set_all(value); }
+    void zero() { get().zero(); }
+    void set_all(T value) { get().set_all(value); }
 
   private:
     DiskTensor<T, Rank> &_parent;
@@ -1323,10 +1379,145 @@ struct DiskView final : public detail::TensorBase<T, ViewRank> {
     Tensor<T, ViewRank> _tensor;
 
     bool _readOnly{false};
+    bool _dirty{false};
 
     // std::unique_ptr<Tensor<ViewRank, T>> _tensor;
 };
 
+namespace detail {
+
+/**
+ * A dataset held open by queued I/O, which may run after the DiskTensor it came from is gone. The access property list is
+ * held too, as h5cpp keeps its id in the h5::ds_t.
+ */
+struct QueuedDataset {
+    explicit QueuedDataset(const h5::ds_t &ds) : access(ds.dapl), ds(ds) {}
+
+    h5::dapl_t access;
+    h5::ds_t ds;
+};
+
+} // namespace detail
+
+/**
+ * DiskView whose disk I/O runs on the I/O thread. The slab starts being read when the view is made and get() waits for
+ * it. Unless the view is read only, the slab is written back in the background when the view is destroyed, or when
+ * put() is called, which returns the future of the write. Reads and writes run in the order they are queued, so a
+ * later view of the same slab sees what an earlier one wrote; io::flush() waits for all of them. The queued I/O holds the
+ * dataset open, so the view and its DiskTensor may go before it is done.
+ */
+template <typename T, size_t ViewRank, size_t Rank>
+struct AsyncDiskView final : public detail::TensorBase<T, ViewRank> {
+    AsyncDiskView(DiskTensor<T, Rank> &parent, const Dim<ViewRank> &dims, const Count<Rank> &counts, const Offset<Rank> &offsets,
+                  const Stride<Rank> & /*strides*/, Access access = Access::ReadWrite)
+        : _disk{std::make_shared<const detail::QueuedDataset>(parent.disk())}, _counts(counts), _offsets(offsets),
+          _tensor{std::make_shared<Tensor<T, ViewRank>>(dims)}, _readOnly{access == Access::Read} {
+        _tensor->set_name(parent.name());
+        if (access == Access::WriteDiscard) {
+            std::promise<void> nothing;
+            nothing.set_value();
+            _read = nothing.get_future().share();
+            return;
+        }
+        _read = io::detail::submit(io::detail::Operation::Read, _tensor->size() * sizeof(T),
+                                   [disk = _disk, tensor = _tensor, counts = _counts, offsets = _offsets] {
+                                       h5::read<T>(disk->ds, tensor->data(), h5::count{counts}, h5::offset{offsets});
+                                   });
+    }
+    AsyncDiskView(const DiskTensor<T, Rank> &parent, const Dim<ViewRank> &dims, const Count<Rank> &counts, const Offset<Rank> &offsets,
+                  const Stride<Rank> &strides)
+        : AsyncDiskView(const_cast<DiskTensor<T, Rank> &>(parent), dims, counts, offsets, strides) {
+        set_read_only(true);
+    }
+    AsyncDiskView(const AsyncDiskView &) = delete;
+    AsyncDiskView(AsyncDiskView &&) noexcept = default;
+    auto operator=(const AsyncDiskView &) -> AsyncDiskView & = delete;
+    auto operator=(AsyncDiskView &&) -> AsyncDiskView & = delete;
+
+    // The buffer goes with the write, so it is not copied.
+    ~AsyncDiskView() {
+        if (_tensor && !_readOnly && _dirty)
+            write(std::move(_tensor));
+    }
+
+    void set_read_only(bool readOnly) { _readOnly = readOnly; }
+
+    /// Whether the slab was changed since it was read or last put, so that it would be written back.
+    [[nodiscard]] auto dirty() const -> bool { return _dirty; }
+
+    /// Waits for the read, recording any wait as an I/O stall. The non-const overload marks the slab dirty.
+    auto get() -> Tensor<T, ViewRank> & {
+        io::detail::wait(_read);
+        _dirty = true;
+        return *_tensor;
+    }
+    auto get() const -> const Tensor<T, ViewRank> & {
+        io::detail::wait(_read);
+        return *_tensor;
+    }
+
+    /// Whether the read is done, so that get() would not wait.
+    [[nodiscard]] auto ready() const -> bool { return _read.wait_for(std::chrono::seconds{0}) == std::future_status::ready; }
+
+    [[nodiscard]] auto read_future() const -> const std::shared_future<void> & { return _read; }
+
+    /// Queues a write of a copy of the slab as it is now.
+    auto put() -> std::shared_future<void> {
+        if (_readOnly)
+            throw std::runtime_error("Attempting to write data to a read only disk view.");
+        auto written = write(std::make_shared<Tensor<T, ViewRank>>(std::as_const(*this).get()));
+        _dirty = false;
+        return written;
+    }
+
+    template <typename... MultiIndex>
+    auto operator()(MultiIndex... index) -> T & {
+        return get()(std::forward<MultiIndex>(index)...);
+    }
+
+    template <typename... MultiIndex>
+    auto operator()(MultiIndex... index) const -> const T & {
+        return get()(std::forward<MultiIndex>(index)...);
+    }
+
+    [[nodiscard]] auto dim(int d) const -> size_t { return _tensor->dim(d); }
+    auto dims() const -> Dim<ViewRank> { return _tensor->dims(); }
+
+  private:
+    auto write(std::shared_ptr<Tensor<T, ViewRank>> tensor) -> std::shared_future<void> {
+        const size_t bytes = tensor->size() * sizeof(T);
+        return io::detail::submit(io::detail::Operation::Write, bytes, [disk = _disk, tensor, counts = _counts, offsets = _offsets] {
+            h5::write<T>(disk->ds, tensor->data(), h5::count{counts}, h5::offset{offsets});
+        });
+    }
+
+    std::shared_ptr<const detail::QueuedDataset> _disk;
+    Count<Rank> _counts;
+    Offset<Rank> _offsets;
+    std::shared_ptr<Tensor<T, ViewRank>> _tensor;
+    std::shared_future<void> _read;
+
+    bool _readOnly{false};
+    bool _dirty{false};
+};
+
+/**
+ * Calls f(n, slab) for n = 0, ..., count - 1, where slab is the Tensor of make_slab(n), an AsyncDiskView. While f runs,
+ * the I/O thread reads the next depth - 1 slabs, two for triple buffering, and writes back the slabs already done.
+ */
+template <typename MakeSlab, typename F>
+void for_each_slab(size_t count, MakeSlab &&make_slab, F &&f, size_t depth = 2) {
+    using Slab = std::decay_t<decltype(make_slab(size_t{0}))>;
+    std::deque<Slab> queued;
+    size_t next = 0;
+    for (size_t n = 0; n < count; n++) {
+        for (; next < count && next < n + std::max<size_t>(depth, 1); next++)
+            queued.push_back(make_slab(next));
+        f(n, queued.front().get());
+        queued.pop_front();
+    }
+}
+
 #ifdef __cpp_deduction_guides
 template <typename... Args>
 Tensor(const std::string &, Args...) -> Tensor<double, sizeof...(Args)>;
@@ -1348,6 +1539,8 @@ TensorView(std::string, Tensor<T, OtherRank> &, const Dim<Rank> &, Args...) -> T
 
 template <typename... Dims>
 DiskTensor(h5::fd_t &file, std::string name, Dims... dims) -> DiskTensor<double, sizeof...(Dims)>;
+template <typename... Dims>
+DiskTensor(h5::fd_t &file, std::string name, const StoragePolicy &policy, Dims... dims) -> DiskTensor<double, sizeof...(Dims)>;
 
 // Supposedly C++20 will allow template deduction guides for template aliases. i.e. Dim, Stride, Offset, Count, Range.
 #endif
@@ -2,28 +2,39 @@
 
 #include "LinearAlgebra.hpp"
 #include "OpenMP.h"
+#include "PlanCache.hpp"
 #include "Print.hpp"
 #include "STL.hpp"
 #include "Section.hpp"
+#include "Telemetry.hpp"
 #include "Tensor.hpp"
 #include "_Index.hpp"
+#include "_LoopNest.hpp"
 
 #include <cmath>
 #if defined(EINSUMS_USE_HPTT)
 #include "hptt.h"
 #endif
 #include "range/v3/view/cartesian_product.hpp"
+#include "range/v3/view/single.hpp"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <functional>
+#include <limits>
+#include <map>
+#include <memory>
 #include <numeric>
+#include <random>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #if defined(EINSUMS_USE_CATCH2)
 #include <catch2/catch.hpp>
@@ -279,6 +290,36 @@ constexpr auto last_stride(const std::tuple<PositionsInX...> &indices, const XTy
     return X.stride(std::get<sizeof...(PositionsInX) - 1>(indices));
 }
 
+/**
+ * True if BLAS can address X as a row-major matrix whose rows are its first Split indices and whose columns are the
+ * others: each group of indices must fuse into a single index with a uniform stride, the columns must have unit stride,
+ * and the leading dimension must cover a row. With Split equal to 0 or to the rank, X is a vector and only has to fuse.
+ */
+template <size_t Split, template <typename, size_t> typename XType, size_t XRank, typename T>
+auto is_blas_layout(const XType<T, XRank> &X) -> bool {
+    for (size_t d = 0; d + 1 < XRank; d++) {
+        if (d + 1 != Split && X.stride(d) != X.stride(d + 1) * X.dim(d + 1))
+            return false;
+    }
+    if constexpr (Split == 0 || Split == XRank)
+        return true;
+    else
+        return X.stride(XRank - 1) == 1 && X.stride(Split - 1) >= X.stride(Split) * X.dim(Split);
+}
+
+/// Step taken through X when the loop over UniqueIndex advances: the sum of the strides of every position of X that
+/// carries UniqueIndex, or zero if X does not depend on it.
+template <typename UniqueIndex, typename... XIndices, template <typename, size_t> typename XType, size_t XRank, typename T>
+auto loop_step(const std::tuple<XIndices...> &, const XType<T, XRank> &X) -> size_t {
+    size_t step{0};
+    for_sequence<XRank>([&](auto p) {
+        if constexpr (std::is_same_v<std::decay_t<std::tuple_element_t<decltype(p)::value, std::tuple<XIndices...>>>,
+                                     std::decay_t<UniqueIndex>>)
+            step += X.stride(p);
+    });
+    return step;
+}
+
 template <typename LHS, typename RHS>
 constexpr auto same_indices() {
     if constexpr (std::tuple_size_v<LHS> != std::tuple_size_v<RHS>)
@@ -287,6 +328,393 @@ constexpr auto same_indices() {
         return detail::same_indices<LHS, RHS>(std::make_index_sequence<std::tuple_size_v<LHS>>());
 }
 
+#if defined(EINSUMS_USE_HPTT)
+/**
+ * HPTT accepts a subblock of a larger packed row-major array through the extents of that array (its outer size). Fills
+ * outer_size for tensor and returns true if the strides of tensor describe such a subblock.
+ */
+template <typename TensorType, size_t Rank>
+auto hptt_outer_size(const TensorType &tensor, std::array<int, Rank> &outer_size) -> bool {
+    if (tensor.stride(Rank - 1) != 1)
+        return false;
+
+    outer_size[0] = static_cast<int>(tensor.dim(0));
+    for (size_t d = 1; d < Rank; d++) {
+        const size_t stride = tensor.stride(d);
+        if (stride == 0 || tensor.stride(d - 1) % stride != 0 || tensor.stride(d - 1) / stride < tensor.dim(d))
+            return false;
+        outer_size[d] = static_cast<int>(tensor.stride(d - 1) / stride);
+    }
+    return true;
+}
+#endif
+
+/**
+ * Transposition kernel for operands with arbitrary strides. nest walks C in storage order. When A is contiguous along
+ * another loop than the innermost one, those two loops are tiled so that a tile of A and of C stays in L1 while it is
+ * read along one and written along the other.
+ */
+template <size_t Rank, typename T>
+void sort_strided_kernel(const ::einsums::detail::LoopNest<Rank, 2> &nest, const T C_prefactor, T *c, const T A_prefactor, const T *a) {
+    size_t fast = Rank - 1;
+    for (size_t d = 0; d < Rank; d++) {
+        if (nest.dims[d] > 1 && nest.steps[d][1] < nest.steps[fast][1])
+            fast = d;
+    }
+
+    if constexpr (Rank >= 2) {
+        constexpr size_t inner = Rank - 1;
+        if (fast != inner && nest.dims[inner] > 1) {
+            ::einsums::detail::LoopNest<Rank - 2, 2> outer;
+            for (size_t d = 0, o = 0; d < inner; d++) {
+                if (d != fast) {
+                    outer.dims[o] = nest.dims[d];
+                    outer.steps[o] = nest.steps[d];
+                    o++;
+                }
+            }
+
+            size_t tile = 8;
+            while (2 * (2 * tile) * (2 * tile) * sizeof(T) <= ::einsums::detail::l1_data_cache_size())
+                tile *= 2;
+
+            const size_t rows = nest.dims[fast], cols = nest.dims[inner];
+            const size_t row_tiles = (rows + tile - 1) / tile, col_tiles = (cols + tile - 1) / tile;
+            const size_t tiles = outer.size() * row_tiles * col_tiles;
+            const auto [c_row, a_row] = nest.steps[fast];
+            const auto [c_col, a_col] = nest.steps[inner];
+
+#pragma omp parallel for schedule(static)
+            for (size_t t = 0; t < tiles; t++) {
+                const auto base = outer.offsets(t / (row_tiles * col_tiles));
+                const size_t row_begin = (t / col_tiles) % row_tiles * tile, row_end = std::min(rows, row_begin + tile);
+                const size_t col_begin = t % col_tiles * tile, col_end = std::min(cols, col_begin + tile);
+
+                for (size_t i = row_begin; i < row_end; i++) {
+                    T *c_i = c + base[0] + i * c_row;
+                    const T *a_i = a + base[1] + i * a_row;
+                    if (C_prefactor == T{0}) {
+                        for (size_t j = col_begin; j < col_end; j++)
+                            c_i[j * c_col] = A_prefactor * a_i[j * a_col];
+                    } else {
+                        for (size_t j = col_begin; j < col_end; j++)
+                            c_i[j * c_col] = C_prefactor * c_i[j * c_col] + A_prefactor * a_i[j * a_col];
+                    }
+                }
+            }
+            return;
+        }
+    }
+
+    // As in BLAS, C is not read when C_prefactor is zero, so it may be uninitialized.
+    if (C_prefactor == T{0}) {
+        nest.parallel_for_each([&](const std::array<size_t, 2> &offset) { c[offset[0]] = A_prefactor * a[offset[1]]; });
+    } else {
+        nest.parallel_for_each([&](const std::array<size_t, 2> &offset) {
+            T &target_value = c[offset[0]];
+            target_value = C_prefactor * target_value + A_prefactor * a[offset[1]];
+        });
+    }
+}
+
+} // namespace detail
+
+/**
+ * Time sort may spend choosing how to perform a transposition. Estimate takes HPTT's heuristic choice. The others time
+ * candidate plans on the data, for up to roughly 10 seconds, a minute and an hour respectively, which only pays off when
+ * the plan is reused: through the plan cache within a run, or through plan_cache::save_wisdom across runs.
+ */
+enum class PlanningEffort { Estimate, Measure, Patient, Exhaustive };
+
+//
+// sort algorithm
+//
+template <template <typename, size_t> typename AType, size_t ARank, template <typename, size_t> typename CType, size_t CRank,
+          typename... CIndices, typename... AIndices, typename U, typename T = double>
+auto sort(const U UC_prefactor, const std::tuple<CIndices...> &C_indices, CType<T, CRank> *C, const U UA_prefactor,
+          const std::tuple<AIndices...> &A_indices, const AType<T, ARank> &A, const PlanningEffort effort = PlanningEffort::Estimate)
+    -> std::enable_if_t<std::is_base_of_v<::einsums::detail::TensorBase<T, CRank>, CType<T, CRank>> &&
+                        std::is_base_of_v<::einsums::detail::TensorBase<T, ARank>, AType<T, ARank>> &&
+                        sizeof...(CIndices) == sizeof...(AIndices) && sizeof...(CIndices) == CRank && sizeof...(AIndices) == ARank &&
+                        std::is_arithmetic_v<U>> {
+
+    Section section{FP_ZERO != std::fpclassify(UC_prefactor)
+                        ? fmt::format(R"(sort: "{}"{} = {} "{}"{} + {} "{}"{})", C->name(), print_tuple_no_type(C_indices), UA_prefactor,
+                                      A.name(), print_tuple_no_type(A_indices), UC_prefactor, C->name(), print_tuple_no_type(C_indices))
+                        : fmt::format(R"(sort: "{}"{} = {} "{}"{})", C->name(), print_tuple_no_type(C_indices), UA_prefactor, A.name(),
+                                      print_tuple_no_type(A_indices))};
+
+    const T C_prefactor = UC_prefactor;
+    const T A_prefactor = UA_prefactor;
+
+    // Error check:  If there are any remaining indices then we cannot perform a sort
+    constexpr auto check = difference_t<std::tuple<AIndices...>, std::tuple<CIndices...>>();
+    static_assert(std::tuple_size_v<decltype(check)> == 0);
+
+#if defined(EINSUMS_USE_HPTT)
+    auto target_position_in_A = detail::find_type_with_position(C_indices, A_indices);
+
+    // HPTT takes Tensors, and TensorViews that are subblocks of a packed array, such as a block sliced out of a larger
+    // tensor. Other strides go to the kernel below.
+    if constexpr (is_incore_rank_tensor_v<CType<T, CRank>, CRank, T> && is_incore_rank_tensor_v<AType<T, ARank>, ARank, T> && ARank != 0) {
+        std::array<int, ARank> outer_size_A{};
+        std::array<int, CRank> outer_size_C{};
+        if (detail::hptt_outer_size(A, outer_size_A) && detail::hptt_outer_size(*C, outer_size_C)) {
+            std::array<int, ARank> perms{};
+            std::array<int, ARank> size{};
+
+            for (int i0 = 0; i0 < ARank; i0++) {
+                perms[i0] = get_from_tuple<unsigned long>(target_position_in_A, (2 * i0) + 1);
+                size[i0] = A.dim(i0);
+            }
+
+            // Reuse the HPTT plan of an earlier sort with the same indices and layouts, unless another thread is using it. HPTT
+            // uses a different kernel when C_prefactor is zero, so measured plans are kept apart for that case.
+            const int threads = omp_get_max_threads();
+            auto key = plan_cache::detail::make_key<std::tuple<std::tuple<CIndices...>, std::tuple<AIndices...>, T>>(threads, A, *C);
+            key.shape.push_back(static_cast<size_t>(effort));
+            key.shape.push_back(C_prefactor == T{0});
+            auto cached = plan_cache::detail::find(key);
+            std::unique_lock<std::mutex> cached_lock{cached->mutex, std::try_to_lock};
+
+            constexpr std::array<hptt::SelectionMethod, 4> methods{hptt::ESTIMATE, hptt::MEASURE, hptt::PATIENT, hptt::CRAZY};
+            const auto method = methods[static_cast<size_t>(effort)];
+            std::shared_ptr<hptt::Transpose<T>> plan;
+            if (cached_lock.owns_lock() && cached->transpose) {
+                plan = std::static_pointer_cast<hptt::Transpose<T>>(cached->transpose);
+                plan->setAlpha(A_prefactor);
+                plan->setBeta(C_prefactor);
+                plan->setInputPtr(A.data());
+                plan->setOutputPtr(C->data());
+            } else if (const int candidate = effort == PlanningEffort::Estimate ? -1 : plan_cache::detail::find_wisdom(key);
+                       candidate != -1) {
+                // Rebuild the candidate an earlier measurement selected without measuring again.
+                plan = hptt::create_plan(perms.data(), ARank, A_prefactor, A.data(), size.data(), outer_size_A.data(), C_prefactor,
+                                         C->data(), outer_size_C.data(), hptt::ESTIMATE, threads, nullptr, true);
+                plan->setSelectionMethod(method);
+                plan->setSelectedCandidate(candidate);
+                plan->createPlan();
+            } else {
+                plan = hptt::create_plan(perms.data(), ARank, A_prefactor, A.data(), size.data(), outer_size_A.data(), C_prefactor,
+                                         C->data(), outer_size_C.data(), method, threads, nullptr, true);
+                if (effort != PlanningEffort::Estimate)
+                    plan_cache::detail::add_wisdom(key, plan->getSelectedCandidate());
+            }
+            if (cached_lock.owns_lock() && !cached->transpose)
+                cached->transpose = plan;
+            plan->execute();
+            return;
+        }
+    }
+#endif
+
+    if constexpr (std::is_same_v<decltype(A_indices), decltype(C_indices)>) {
+        if (C_prefactor != T{1.0})
+            linear_algebra::scale(C_prefactor, C);
+        linear_algebra::axpy(A_prefactor, A, C);
+    } else {
+        // Walk C in storage order, stepping through A with the strides of the matching indices.
+        ::einsums::detail::LoopNest<CRank, 2> nest;
+        for_sequence<CRank>([&](auto d) {
+            nest.dims[d] = C->dim(d);
+            nest.steps[d] = {C->stride(d), detail::loop_step<std::tuple_element_t<d, std::tuple<CIndices...>>>(A_indices, A)};
+        });
+
+        detail::sort_strided_kernel(nest, C_prefactor, C->data(), A_prefactor, A.data());
+    }
+} // namespace einsums::TensorAlgebra
+
+// Sort with default values, no smart pointers
+template <typename ObjectA, typename ObjectC, typename... CIndices, typename... AIndices>
+auto sort(const std::tuple<CIndices...> &C_indices, ObjectC *C, const std::tuple<AIndices...> &A_indices, const ObjectA &A)
+    -> std::enable_if_t<!is_smart_pointer_v<ObjectA> && !is_smart_pointer_v<ObjectC>> {
+    sort(0, C_indices, C, 1, A_indices, A);
+}
+
+// Sort with default values, two smart pointers
+template <typename SmartPointerA, typename SmartPointerC, typename... CIndices, typename... AIndices>
+auto sort(const std::tuple<CIndices...> &C_indices, SmartPointerC *C, const std::tuple<AIndices...> &A_indices, const SmartPointerA &A)
+    -> std::enable_if_t<is_smart_pointer_v<SmartPointerA> && is_smart_pointer_v<SmartPointerC>> {
+    sort(0, C_indices, C->get(), 1, A_indices, *A);
+}
+
+// Sort with default values, one smart pointer (A)
+template <typename SmartPointerA, typename PointerC, typename... CIndices, typename... AIndices>
+auto sort(const std::tuple<CIndices...> &C_indices, PointerC *C, const std::tuple<AIndices...> &A_indices, const SmartPointerA &A)
+    -> std::enable_if_t<is_smart_pointer_v<SmartPointerA> && !is_smart_pointer_v<PointerC>> {
+    sort(0, C_indices, C, 1, A_indices, *A);
+}
+
+// Sort with default values, one smart pointer (C)
+template <typename ObjectA, typename SmartPointerC, typename... CIndices, typename... AIndices>
+auto sort(const std::tuple<CIndices...> &C_indices, SmartPointerC *C, const std::tuple<AIndices...> &A_indices, const ObjectA &A)
+    -> std::enable_if_t<!is_smart_pointer_v<ObjectA> && is_smart_pointer_v<SmartPointerC>> {
+    sort(0, C_indices, C->get(), 1, A_indices, A);
+}
+
+namespace detail {
+
+/// Epilogue of an einsum that leaves the result as it is.
+struct NoEpilogue {};
+
+/// Replaces each element of C whose ordinal is in [begin, end) by epilogue(value, indices...).
+template <typename Epilogue, template <typename, size_t> typename CType, typename T, size_t Rank>
+void apply_epilogue(const Epilogue &epilogue, CType<T, Rank> *C, size_t begin = 0, size_t end = std::numeric_limits<size_t>::max()) {
+    size_t size{1};
+    if constexpr (Rank != 0) {
+        for (size_t d = 0; d < Rank; d++)
+            size *= C->dim(d);
+    }
+    end = std::min(end, size);
+
+    T *c = C->data();
+#pragma omp parallel for
+    for (size_t ordinal = begin; ordinal < end; ordinal++) {
+        std::array<size_t, Rank> index{};
+        size_t offset{0};
+        if constexpr (Rank != 0) {
+            size_t remaining = ordinal;
+            for (size_t d = Rank; d-- > 0;) {
+                index[d] = remaining % C->dim(d);
+                remaining /= C->dim(d);
+                offset += index[d] * C->stride(d);
+            }
+        }
+        T &target_value = c[offset];
+        target_value = std::apply([&](auto... i) { return epilogue(target_value, i...); }, index);
+    }
+}
+
+/// Magnitude above which EINSUMS_TEST_NANS reports a value in the result of an einsum as too large.
+constexpr double einsum_large_value = 1.0e8;
+
+/// True for NaN, infinite and too large values. A single comparison, which is false for NaN, catches all three.
+template <typename T>
+inline auto is_suspicious_value(const T value) -> bool {
+    return !(std::abs(value) <= einsum_large_value);
+}
+
+enum class SuspiciousValue { None, NaN, Infinity, Large };
+
+/**
+ * True if any element of C is NaN, infinite or too large. Packed tensors are scanned as one vectorized array, views
+ * run by run with their inner stride; both are split between the OpenMP threads.
+ */
+template <template <typename, size_t> typename CType, typename T, size_t Rank>
+auto has_suspicious_values(const CType<T, Rank> &C) -> bool {
+    if constexpr (!is_incore_rank_tensor_v<CType<T, Rank>, Rank, T>) {
+        for (auto target_combination : std::apply(ranges::views::cartesian_product, get_dim_ranges<Rank>(C))) {
+            if (is_suspicious_value(std::apply(C, target_combination)))
+                return true;
+        }
+        return false;
+    } else {
+        const T *c = C.data();
+        const auto nest = ::einsums::detail::make_loop_nest(C);
+
+        bool packed{true};
+        size_t expected{1};
+        for (size_t d = Rank; d-- > 0;) {
+            packed = packed && (nest.steps[d][0] == expected || nest.dims[d] == 1);
+            expected *= nest.dims[d];
+        }
+
+        int found{0};
+        if (packed) {
+            const size_t size = nest.size();
+#pragma omp parallel for simd reduction(| : found)
+            for (size_t i = 0; i < size; i++)
+                found |= is_suspicious_value(c[i]);
+        } else {
+            std::atomic<bool> any{false};
+            nest.parallel_for_each_run([&](const std::array<size_t, 1> &offset, size_t count, const std::array<size_t, 1> &step) {
+                const T *run = c + offset[0];
+                int run_found{0};
+#pragma omp simd reduction(| : run_found)
+                for (size_t i = 0; i < count; i++)
+                    run_found |= is_suspicious_value(run[i * step[0]]);
+                if (run_found)
+                    any.store(true, std::memory_order_relaxed);
+            });
+            found = any.load();
+        }
+        return found != 0;
+    }
+}
+
+/// The worst kind of suspicious value in C: NaN over infinity over too large.
+template <template <typename, size_t> typename CType, typename T, size_t Rank>
+auto classify_suspicious_values(const CType<T, Rank> &C) -> SuspiciousValue {
+    SuspiciousValue worst{SuspiciousValue::None};
+    for (auto target_combination : std::apply(ranges::views::cartesian_product, get_dim_ranges<Rank>(C))) {
+        const T value = std::apply(C, target_combination);
+        if (std::isnan(value))
+            return SuspiciousValue::NaN;
+        if (std::isinf(value))
+            worst = SuspiciousValue::Infinity;
+        else if (worst == SuspiciousValue::None && is_suspicious_value(value))
+            worst = SuspiciousValue::Large;
+    }
+    return worst;
+}
+
+/**
+ * Epilogue that checks each value produced by another epilogue as it is stored, while it is still in cache. Used by
+ * EINSUMS_TEST_NANS on einsums with an epilogue in place of a separate scan of C.
+ */
+template <typename Epilogue>
+struct CheckedEpilogue {
+    const Epilogue &epilogue;
+    std::atomic<bool> *suspicious;
+
+    template <typename T, typename... Index>
+    auto operator()(const T value, const Index... index) const {
+        auto result = epilogue(value, index...);
+        if (is_suspicious_value(result))
+            suspicious->store(true, std::memory_order_relaxed);
+        return result;
+    }
+};
+
+/// Target spaces with fewer elements than this per thread are too small to share between threads, so the link space is
+/// split between them instead.
+constexpr size_t einsum_small_target_per_thread = 4;
+
+/// True if an einsum with these sizes should parallelize over its link space rather than its target space.
+inline auto use_link_parallelism(size_t target_size, size_t link_size) -> bool {
+    const size_t threads = omp_get_max_threads();
+    return threads > 1 && target_size < einsum_small_target_per_thread * threads && link_size >= threads;
+}
+
+/**
+ * Adds the partial sums of each thread together in a binary tree, leaving the totals in partials[0]. Must be called by
+ * every thread of the enclosing parallel region, each owning partials[omp_get_thread_num()].
+ */
+template <typename T>
+void tree_reduce(std::vector<std::vector<T>> &partials) {
+    const size_t threads = omp_get_num_threads();
+    const size_t thread = omp_get_thread_num();
+    for (size_t distance = 1; distance < threads; distance *= 2) {
+#pragma omp barrier
+        if (thread % (2 * distance) == 0 && thread + distance < threads) {
+            std::vector<T> &into = partials[thread];
+            const std::vector<T> &from = partials[thread + distance];
+            for (size_t t = 0; t < into.size(); t++)
+                into[t] += from[t];
+        }
+    }
+#pragma omp barrier
+}
+
+/// Every combination of the target indices. A rank-0 target has a single, empty, combination.
+template <typename... TargetDims>
+auto target_combinations(const std::tuple<TargetDims...> &target_dims) {
+    if constexpr (sizeof...(TargetDims) == 0)
+        return ranges::views::single(std::tuple<>());
+    else
+        return std::apply(ranges::views::cartesian_product, target_dims);
+}
+
 template <typename... CUniqueIndices, typename... AUniqueIndices, typename... BUniqueIndices, typename... LinkUniqueIndices,
           typename... CIndices, typename... AIndices, typename... BIndices, typename... TargetDims, typename... LinkDims,
           typename... TargetPositionInC, typename... LinkPositionInLink, template <typename, size_t> typename CType, typename CDataType,
@@ -302,10 +730,56 @@ void einsum_generic_algorithm(const std::tuple<CUniqueIndices...> &C_unique, con
                               const std::conditional_t<(sizeof(ADataType) > sizeof(BDataType)), ADataType, BDataType> AB_prefactor,
                               const AType<ADataType, ARank> &A, const BType<BDataType, BRank> &B) {
     timer::push("generic algorithm");
+    telemetry::detail::set_algorithm("generic");
 
-    auto view = std::apply(ranges::views::cartesian_product, target_dims);
+    auto view = target_combinations(target_dims);
 
     if constexpr (sizeof...(LinkDims) != 0) {
+        auto link_view = std::apply(ranges::views::cartesian_product, link_dims);
+        const auto target_size = static_cast<size_t>(view.end() - view.begin());
+        const auto link_size = static_cast<size_t>(link_view.end() - link_view.begin());
+
+        if (use_link_parallelism(target_size, link_size)) {
+            // Too few target elements to go around: each thread sums a share of the link space for every target element.
+            std::vector<std::vector<CDataType>> partials(omp_get_max_threads());
+#pragma omp parallel
+            {
+                std::vector<CDataType> &partial = partials[omp_get_thread_num()];
+                partial.assign(target_size, CDataType{0});
+
+#pragma omp for
+                for (auto link = link_view.begin(); link < link_view.end(); link++) {
+                    size_t t{0};
+                    for (auto target_combination : view) {
+                        auto A_order = detail::construct_indices_from_unique_combination<AIndices...>(
+                            C_unique, target_combination, target_position_in_C, link_unique, *link, link_position_in_link);
+                        auto B_order = detail::construct_indices_from_unique_combination<BIndices...>(
+                            C_unique, target_combination, target_position_in_C, link_unique, *link, link_position_in_link);
+
+                        ADataType A_value = std::apply(A, A_order);
+                        BDataType B_value = std::apply(B, B_order);
+                        partial[t++] += AB_prefactor * A_value * B_value;
+                    }
+                }
+
+                tree_reduce(partials);
+            }
+
+            size_t t{0};
+            for (auto target_combination : view) {
+                auto C_order = detail::construct_indices_from_unique_combination<CIndices...>(
+                    C_unique, target_combination, target_position_in_C, std::tuple<>(), std::tuple<>(), target_position_in_C);
+                CDataType &target_value = std::apply(*C, C_order);
+                if (C_prefactor == CDataType{0.0})
+                    target_value = CDataType{0.0};
+                target_value *= C_prefactor;
+                target_value += partials[0][t++];
+            }
+
+            timer::pop();
+            return;
+        }
+
 #if defined(__INTEL_LLVM_COMPILER) || defined(__INTEL_COMPILER)
 #pragma omp parallel for simd
 #else
@@ -384,13 +858,464 @@ void einsum_generic_algorithm(const std::tuple<CUniqueIndices...> &C_unique, con
     timer::pop();
 }
 
+/**
+ * Cache-blocked kernel of the strided algorithm.
+ *
+ * Target elements are processed in tiles and the link space in blocks sized to the L1 cache. The offsets of a link
+ * block are computed once and reused by every target element of the tile, and the partial sums of the tile are kept
+ * in a local buffer while the link blocks are swept. The parts of A and B touched by a block therefore stay in cache
+ * across the target tile instead of being streamed from memory once per target element.
+ *
+ * If given, epilogue(value, ordinal) is applied to each target element as it is stored.
+ */
+template <size_t TargetRank, size_t LinkRank, typename CDataType, typename ABDataType, typename ADataType, typename BDataType,
+          typename Epilogue = NoEpilogue>
+void einsum_tiled_kernel(const ::einsums::detail::LoopNest<TargetRank, 3> &target, const ::einsums::detail::LoopNest<LinkRank, 2> &link,
+                         const CDataType C_prefactor, CDataType *c, const ABDataType AB_prefactor, const ADataType *a, const BDataType *b,
+                         const Epilogue &epilogue = Epilogue{}) {
+    timer::push("tiled kernel");
+
+    const size_t target_size = target.size();
+    const size_t link_size = link.size();
+
+    // A link block holds two offsets plus one element of A and B per link ordinal and should fit in L1. A target tile
+    // should keep the elements of A and B touched by a block resident in L2, and leave a tile for every thread.
+    const size_t link_tile =
+        std::max<size_t>(64, ::einsums::detail::l1_data_cache_size() / (2 * sizeof(size_t) + sizeof(ADataType) + sizeof(BDataType)));
+    const size_t threads = omp_get_max_threads();
+    const size_t target_tile =
+        std::clamp<size_t>(std::min(::einsums::detail::l2_cache_size() / (link_tile * (sizeof(ADataType) + sizeof(BDataType))),
+                                    (target_size + threads - 1) / threads),
+                           8, 512);
+    const size_t tiles = (target_size + target_tile - 1) / target_tile;
+
+#pragma omp parallel
+    {
+        std::vector<std::array<size_t, 3>> target_offsets;
+        std::vector<size_t> A_link_offsets(link_tile), B_link_offsets(link_tile);
+        std::vector<CDataType> sums(target_tile);
+        target_offsets.reserve(target_tile);
+
+#pragma omp for schedule(dynamic)
+        for (size_t tile = 0; tile < tiles; tile++) {
+            const size_t begin = tile * target_tile;
+            const size_t end = std::min(target_size, begin + target_tile);
+
+            target_offsets.clear();
+            target.for_each(begin, end, [&](const std::array<size_t, 3> &offset) { target_offsets.push_back(offset); });
+            std::fill(sums.begin(), sums.end(), CDataType{0});
+
+            for (size_t link_begin = 0; link_begin < link_size; link_begin += link_tile) {
+                size_t links{0};
+                link.for_each(link_begin, std::min(link_size, link_begin + link_tile), [&](const std::array<size_t, 2> &offset) {
+                    A_link_offsets[links] = offset[0];
+                    B_link_offsets[links] = offset[1];
+                    links++;
+                });
+
+                const size_t *la = A_link_offsets.data();
+                const size_t *lb = B_link_offsets.data();
+                for (size_t t = 0; t < target_offsets.size(); t++) {
+                    const ADataType *pa = a + target_offsets[t][1];
+                    const BDataType *pb = b + target_offsets[t][2];
+                    CDataType partial{0};
+                    if constexpr (std::is_arithmetic_v<CDataType>) {
+#pragma omp simd reduction(+ : partial)
+                        for (size_t l = 0; l < links; l++)
+                            partial += AB_prefactor * pa[la[l]] * pb[lb[l]];
+                    } else {
+                        for (size_t l = 0; l < links; l++)
+                            partial += AB_prefactor * pa[la[l]] * pb[lb[l]];
+                    }
+                    sums[t] += partial;
+                }
+            }
+
+            for (size_t t = 0; t < target_offsets.size(); t++) {
+                CDataType &target_value = c[target_offsets[t][0]];
+                if (C_prefactor == CDataType{0.0})
+                    target_value = CDataType{0.0};
+                target_value *= C_prefactor;
+                target_value += sums[t];
+                if constexpr (!std::is_same_v<Epilogue, NoEpilogue>)
+                    target_value = epilogue(target_value, begin + t);
+            }
+        }
+    }
+
+    timer::pop();
+}
+
+/**
+ * Kernel of the strided algorithm for target spaces too small to share between threads, such as a scalar result.
+ *
+ * Each thread sums its share of the link space into private partial sums for every target element, and the partial
+ * sums are combined with tree_reduce. If given, epilogue(value, ordinal) is applied to each target element as it is
+ * stored.
+ */
+template <size_t TargetRank, size_t LinkRank, typename CDataType, typename ABDataType, typename ADataType, typename BDataType,
+          typename Epilogue = NoEpilogue>
+void einsum_link_parallel_kernel(const ::einsums::detail::LoopNest<TargetRank, 3> &target,
+                                 const ::einsums::detail::LoopNest<LinkRank, 2> &link, const CDataType C_prefactor, CDataType *c,
+                                 const ABDataType AB_prefactor, const ADataType *a, const BDataType *b,
+                                 const Epilogue &epilogue = Epilogue{}) {
+    timer::push("link parallel kernel");
+
+    const size_t target_size = target.size();
+    const size_t link_size = link.size();
+
+    std::vector<std::array<size_t, 3>> target_offsets;
+    target_offsets.reserve(target_size);
+    target.for_each(0, target_size, [&](const std::array<size_t, 3> &offset) { target_offsets.push_back(offset); });
+
+    std::vector<std::vector<CDataType>> partials(omp_get_max_threads());
+#pragma omp parallel
+    {
+        const size_t threads = omp_get_num_threads();
+        const size_t thread = omp_get_thread_num();
+        const size_t chunk = (link_size + threads - 1) / threads;
+        const size_t begin = std::min(link_size, thread * chunk);
+        const size_t end = std::min(link_size, begin + chunk);
+
+        std::vector<CDataType> &partial = partials[thread];
+        partial.assign(target_size, CDataType{0});
+
+        link.for_each_run(begin, end, [&](const std::array<size_t, 2> &l, size_t count, const std::array<size_t, 2> &step) {
+            for (size_t t = 0; t < target_size; t++) {
+                const ADataType *pa = a + target_offsets[t][1] + l[0];
+                const BDataType *pb = b + target_offsets[t][2] + l[1];
+                CDataType sum{0};
+                if constexpr (std::is_arithmetic_v<CDataType>) {
+#pragma omp simd reduction(+ : sum)
+                    for (size_t i = 0; i < count; i++)
+                        sum += AB_prefactor * pa[i * step[0]] * pb[i * step[1]];
+                } else {
+                    for (size_t i = 0; i < count; i++)
+                        sum += AB_prefactor * pa[i * step[0]] * pb[i * step[1]];
+                }
+                partial[t] += sum;
+            }
+        });
+
+        tree_reduce(partials);
+    }
+
+    for (size_t t = 0; t < target_size; t++) {
+        CDataType &target_value = c[target_offsets[t][0]];
+        if (C_prefactor == CDataType{0.0})
+            target_value = CDataType{0.0};
+        target_value *= C_prefactor;
+        target_value += partials[0][t];
+        if constexpr (!std::is_same_v<Epilogue, NoEpilogue>)
+            target_value = epilogue(target_value, t);
+    }
+
+    timer::pop();
+}
+
+/**
+ * Generic algorithm driven by a strided loop nest.
+ *
+ * Produces the same result as einsum_generic_algorithm but walks the unique target and link indices with precomputed
+ * offset steps instead of constructing the index tuple of every element. The link loop of each target element is
+ * performed as a series of (possibly strided) dot products.
+ */
+template <typename... CUniqueIndices, typename... LinkUniqueIndices, typename... CIndices, typename... AIndices, typename... BIndices,
+          template <typename, size_t> typename CType, typename CDataType, size_t CRank, template <typename, size_t> typename AType,
+          typename ADataType, size_t ARank, template <typename, size_t> typename BType, typename BDataType, size_t BRank,
+          typename Epilogue = NoEpilogue>
+void einsum_strided_algorithm(const std::tuple<CUniqueIndices...> & /*C_unique*/, const std::tuple<LinkUniqueIndices...> & /*link_unique*/,
+                              const std::tuple<CIndices...> &C_indices, const std::tuple<AIndices...> &A_indices,
+                              const std::tuple<BIndices...> &B_indices, const CDataType C_prefactor, CType<CDataType, CRank> *C,
+                              const std::conditional_t<(sizeof(ADataType) > sizeof(BDataType)), ADataType, BDataType> AB_prefactor,
+                              const AType<ADataType, ARank> &A, const BType<BDataType, BRank> &B, const Epilogue &epilogue = Epilogue{}) {
+    timer::push("strided algorithm");
+
+    ::einsums::detail::LoopNest<sizeof...(CUniqueIndices), 3> target;
+    target.dims = {C->dim(find_position<CUniqueIndices, CIndices...>())...};
+    target.steps = {std::array<size_t, 3>{loop_step<CUniqueIndices>(C_indices, *C), loop_step<CUniqueIndices>(A_indices, A),
+                                          loop_step<CUniqueIndices>(B_indices, B)}...};
+
+    ::einsums::detail::LoopNest<sizeof...(LinkUniqueIndices), 2> link;
+    link.dims = {A.dim(find_position<LinkUniqueIndices, AIndices...>())...};
+    link.steps = {std::array<size_t, 2>{loop_step<LinkUniqueIndices>(A_indices, A), loop_step<LinkUniqueIndices>(B_indices, B)}...};
+    const size_t link_size = link.size();
+
+    CDataType *c = C->data();
+    const ADataType *a = A.data();
+    const BDataType *b = B.data();
+
+    // An epilogue is applied by the tiled kernel as each target element is stored. The ordinal of the element in the
+    // target loop nest gives its unique indices, and those give its indices in C.
+    if constexpr (!std::is_same_v<Epilogue, NoEpilogue>) {
+        auto at_ordinal = [&epilogue, dims = target.dims](const CDataType value, size_t ordinal) -> CDataType {
+            std::array<size_t, sizeof...(CUniqueIndices)> unique{};
+            for (size_t d = sizeof...(CUniqueIndices); d-- > 0;) {
+                unique[d] = ordinal % dims[d];
+                ordinal /= dims[d];
+            }
+            return epilogue(value, unique[find_position<CIndices, CUniqueIndices...>()]...);
+        };
+        if (use_link_parallelism(target.size(), link_size)) {
+            telemetry::detail::set_algorithm("link parallel");
+            einsum_link_parallel_kernel(target, link, C_prefactor, c, AB_prefactor, a, b, at_ordinal);
+        } else {
+            telemetry::detail::set_algorithm("tiled");
+            einsum_tiled_kernel(target, link, C_prefactor, c, AB_prefactor, a, b, at_ordinal);
+        }
+        timer::pop();
+        return;
+    }
+
+    if (use_link_parallelism(target.size(), link_size)) {
+        telemetry::detail::set_algorithm("link parallel");
+        einsum_link_parallel_kernel(target, link, C_prefactor, c, AB_prefactor, a, b);
+        timer::pop();
+        return;
+    }
+
+    // Once the A and B elements needed by a single target element no longer fit in L1, block the loops so those
+    // elements are reused by neighbouring target elements before being evicted.
+    if (target.size() > 1 && link_size * (sizeof(ADataType) + sizeof(BDataType)) > ::einsums::detail::l1_data_cache_size()) {
+        telemetry::detail::set_algorithm("tiled");
+        einsum_tiled_kernel(target, link, C_prefactor, c, AB_prefactor, a, b);
+        timer::pop();
+        return;
+    }
+
+    telemetry::detail::set_algorithm("strided");
+    target.parallel_for_each([&](const std::array<size_t, 3> &t) {
+        CDataType sum{0};
+        link.for_each_run(0, link_size, [&](const std::array<size_t, 2> &l, size_t count, const std::array<size_t, 2> &step) {
+            const ADataType *pa = a + t[1] + l[0];
+            const BDataType *pb = b + t[2] + l[1];
+            CDataType partial{0};
+            if constexpr (std::is_arithmetic_v<CDataType>) {
+                if (step[0] == 1 && step[1] == 1) {
+#pragma omp simd reduction(+ : partial)
+                    for (size_t i = 0; i < count; i++)
+                        partial += AB_prefactor * pa[i] * pb[i];
+                } else {
+#pragma omp simd reduction(+ : partial)
+                    for (size_t i = 0; i < count; i++)
+                        partial += AB_prefactor * pa[i * step[0]] * pb[i * step[1]];
+                }
+            } else {
+                for (size_t i = 0; i < count; i++)
+                    partial += AB_prefactor * pa[i * step[0]] * pb[i * step[1]];
+            }
+            sum += partial;
+        });
+
+        CDataType &target_value = c[t[0]];
+        if (C_prefactor == CDataType{0.0})
+            target_value = CDataType{0.0};
+        target_value *= C_prefactor;
+        target_value += sum;
+    });
+
+    timer::pop();
+}
+
+/// Minimum number of floating-point operations performed per element copied before the TTGT algorithm is preferred over the
+/// generic algorithm. Permuting a tensor costs roughly one read and one write per element.
+constexpr double ttgt_minimum_flops_per_element = 2.0;
+
+/// Batched gemms with fewer multiply-adds than this are distributed over OpenMP threads one batch at a time. Larger ones are
+/// performed one after another, leaving the threading to BLAS.
+constexpr size_t ttgt_parallel_batch_limit = 64 * 64 * 64;
+
+template <typename... SortedIndices, typename... XIndices, template <typename, size_t> typename XType, size_t XRank, typename T>
+auto ttgt_sorted_dims(const std::tuple<SortedIndices...> &, const std::tuple<XIndices...> &, const XType<T, XRank> &X)
+    -> Dim<sizeof...(SortedIndices)> {
+    return Dim<sizeof...(SortedIndices)>{X.dim(find_position<SortedIndices, XIndices...>())...};
+}
+
+/**
+ * Transpose-Transpose-GEMM-Transpose (TTGT) algorithm.
+ *
+ * Handles contractions whose target and link indices are not grouped contiguously in the tensors. A is permuted to
+ * (batch, CA, links) or (batch, links, CA), B to (batch, links, CB) or (batch, CB, links), and the contraction is performed
+ * with one gemm per combination of the batch indices, i.e. the indices found in A, B, and C. If C is not laid out as
+ * (batch, CA, CB) or (batch, CB, CA) the result is accumulated into C with a final permutation.
+ *
+ * Tensors that already have a compatible layout are used in place. Returns false, without touching C, if such a tensor
+ * is not contiguous or if the arithmetic intensity of the contraction is too low to justify the permutations.
+ *
+ * If given, epilogue(value, indices...) is applied to each element of C as it is stored: after the gemm of its batch,
+ * or by the final permutation, which then walks C itself rather than going through sort.
+ */
+template <typename... BatchIndices, typename... CAIndices, typename... LinkIndices, typename... CBIndices, typename... CIndices,
+          typename... AIndices, typename... BIndices, template <typename, size_t> typename CType, size_t CRank,
+          template <typename, size_t> typename AType, size_t ARank, template <typename, size_t> typename BType, size_t BRank, typename T,
+          typename Epilogue = NoEpilogue>
+auto einsum_ttgt_algorithm(const std::tuple<BatchIndices...> &batch_indices, const std::tuple<CAIndices...> &CA_indices,
+                           const std::tuple<LinkIndices...> &link_indices, const std::tuple<CBIndices...> &CB_indices, const T C_prefactor,
+                           const std::tuple<CIndices...> &C_indices, CType<T, CRank> *C, const T AB_prefactor,
+                           const std::tuple<AIndices...> &A_indices, const AType<T, ARank> &A, const std::tuple<BIndices...> &B_indices,
+                           const BType<T, BRank> &B, const Epilogue &epilogue = Epilogue{}) -> bool {
+    constexpr bool has_epilogue = !std::is_same_v<Epilogue, NoEpilogue>;
+
+    using ANormal = std::tuple<std::decay_t<BatchIndices>..., std::decay_t<CAIndices>..., std::decay_t<LinkIndices>...>;
+    using ATransposed = std::tuple<std::decay_t<BatchIndices>..., std::decay_t<LinkIndices>..., std::decay_t<CAIndices>...>;
+    using BNormal = std::tuple<std::decay_t<BatchIndices>..., std::decay_t<LinkIndices>..., std::decay_t<CBIndices>...>;
+    using BTransposed = std::tuple<std::decay_t<BatchIndices>..., std::decay_t<CBIndices>..., std::decay_t<LinkIndices>...>;
+    using CNormal = std::tuple<std::decay_t<BatchIndices>..., std::decay_t<CAIndices>..., std::decay_t<CBIndices>...>;
+    using CTransposed = std::tuple<std::decay_t<BatchIndices>..., std::decay_t<CBIndices>..., std::decay_t<CAIndices>...>;
+
+    constexpr bool A_is_normal = std::is_same_v<std::tuple<AIndices...>, ANormal>;
+    constexpr bool A_is_transposed = std::is_same_v<std::tuple<AIndices...>, ATransposed>;
+    constexpr bool B_is_normal = std::is_same_v<std::tuple<BIndices...>, BNormal>;
+    constexpr bool B_is_transposed = std::is_same_v<std::tuple<BIndices...>, BTransposed>;
+    constexpr bool C_is_normal = std::is_same_v<std::tuple<CIndices...>, CNormal>;
+    constexpr bool C_is_transposed = std::is_same_v<std::tuple<CIndices...>, CTransposed>;
+
+    const size_t batches = product_dims(find_type_with_position(batch_indices, C_indices), *C);
+    const size_t m = product_dims(find_type_with_position(CA_indices, C_indices), *C);
+    const size_t n = product_dims(find_type_with_position(CB_indices, C_indices), *C);
+    const size_t k = product_dims(find_type_with_position(link_indices, A_indices), A);
+
+    if (batches == 0 || m == 0 || n == 0 || k == 0)
+        return false;
+
+    // Tensors with a compatible layout are used in place, the others are permuted into the normal layout.
+    constexpr bool permute_A = !(A_is_normal || A_is_transposed);
+    constexpr bool permute_B = !(B_is_normal || B_is_transposed);
+    constexpr bool permute_C = !(C_is_normal || C_is_transposed);
+
+    constexpr bool transpose_A = A_is_transposed;
+    constexpr bool transpose_B = B_is_transposed;
+    constexpr bool transpose_C = C_is_transposed;
+
+    // The in place tensors are handed directly to gemm which requires them to be contiguous.
+    if ((!permute_A && !A.full_view_of_underlying()) || (!permute_B && !B.full_view_of_underlying()) ||
+        (!permute_C && !C->full_view_of_underlying()))
+        return false;
+
+    // Compare the work of the gemms with the number of elements moved by the permutations.
+    const double flops = 2.0 * static_cast<double>(batches) * static_cast<double>(m) * static_cast<double>(n) * static_cast<double>(k);
+    const double moved = static_cast<double>(batches) * ((permute_A ? static_cast<double>(m * k) : 0.0) +
+                                                         (permute_B ? static_cast<double>(k * n) : 0.0) +
+                                                         (permute_C ? 2.0 * static_cast<double>(m * n) : 0.0));
+    if (flops < ttgt_minimum_flops_per_element * moved)
+        return false;
+
+    timer::push("ttgt algorithm");
+
+    Tensor<T, ARank> sA;
+    Tensor<T, BRank> sB;
+    Tensor<T, CRank> sC;
+
+    if constexpr (permute_A) {
+        sA = Tensor<T, ARank>{ttgt_sorted_dims(ANormal(), A_indices, A)};
+        sA.set_name(fmt::format("{} (ttgt)", A.name()));
+        sort(T{0}, ANormal(), &sA, T{1}, A_indices, A);
+    }
+    if constexpr (permute_B) {
+        sB = Tensor<T, BRank>{ttgt_sorted_dims(BNormal(), B_indices, B)};
+        sB.set_name(fmt::format("{} (ttgt)", B.name()));
+        sort(T{0}, BNormal(), &sB, T{1}, B_indices, B);
+    }
+    if constexpr (permute_C) {
+        sC = Tensor<T, CRank>{ttgt_sorted_dims(CNormal(), C_indices, *C)};
+        sC.set_name(fmt::format("{} (ttgt)", C->name()));
+    }
+
+    const T *a = permute_A ? sA.data() : A.data();
+    const T *b = permute_B ? sB.data() : B.data();
+    T *c = permute_C ? sC.data() : C->data();
+
+    // Row-major leading dimensions of each batch.
+    const int lda = transpose_A ? m : k;
+    const int ldb = transpose_B ? k : n;
+    const int ldc = transpose_C ? m : n;
+    const T beta = permute_C ? T{0} : C_prefactor;
+
+    auto gemm_batch = [&](size_t batch) {
+        if constexpr (!transpose_C) {
+            // C = op(A) op(B)
+            blas::gemm(transpose_A ? 't' : 'n', transpose_B ? 't' : 'n', m, n, k, AB_prefactor, a + batch * m * k, lda,
+                       b + batch * k * n, ldb, beta, c + batch * m * n, ldc);
+        } else {
+            // C^T = op(B)^T op(A)^T
+            blas::gemm(transpose_B ? 'n' : 't', transpose_A ? 'n' : 't', n, m, k, AB_prefactor, b + batch * k * n, ldb,
+                       a + batch * m * k, lda, beta, c + batch * m * n, ldc);
+        }
+        // C is used in place, so its elements are in batch order and those of the batch are still in cache.
+        if constexpr (has_epilogue && !permute_C)
+            apply_epilogue(epilogue, C, batch * m * n, (batch + 1) * m * n);
+    };
+
+    timer::push("gemm");
+    if (batches > 1 && m * n * k < ttgt_parallel_batch_limit) {
+#pragma omp parallel for
+        for (size_t batch = 0; batch < batches; batch++) {
+            gemm_batch(batch);
+        }
+    } else {
+        for (size_t batch = 0; batch < batches; batch++) {
+            gemm_batch(batch);
+        }
+    }
+    timer::pop();
+
+    if constexpr (permute_C && has_epilogue) {
+        // Permute back into C, applying the epilogue as each element is stored.
+        std::array<size_t, CRank> sC_strides{};
+        for_sequence<CRank>([&](auto d) { sC_strides[d] = loop_step<std::tuple_element_t<d, std::tuple<CIndices...>>>(CNormal(), sC); });
+
+        T *target = C->data();
+        const T *source = sC.data();
+        const size_t size = batches * m * n;
+#pragma omp parallel for
+        for (size_t ordinal = 0; ordinal < size; ordinal++) {
+            std::array<size_t, CRank> index{};
+            size_t target_offset{0}, source_offset{0};
+            size_t remaining = ordinal;
+            for (size_t d = CRank; d-- > 0;) {
+                index[d] = remaining % C->dim(d);
+                remaining /= C->dim(d);
+                target_offset += index[d] * C->stride(d);
+                source_offset += index[d] * sC_strides[d];
+            }
+            T &target_value = target[target_offset];
+            const T value = C_prefactor == T{0} ? source[source_offset] : C_prefactor * target_value + source[source_offset];
+            target_value = std::apply([&](auto... i) { return epilogue(value, i...); }, index);
+        }
+    } else if constexpr (permute_C) {
+        sort(C_prefactor, C_indices, C, T{1}, CNormal(), sC);
+    }
+
+    timer::pop();
+    return true;
+}
+
+/// Type a mixed-type einsum is computed in: the widest of the real types, complex if any of the types is.
+template <typename... Ts>
+using mixed_compute_t = std::conditional_t<(is_complex_v<Ts> || ...), std::complex<std::common_type_t<complex_type_t<Ts>...>>,
+                                           std::common_type_t<complex_type_t<Ts>...>>;
+
+/// tensor itself if it already holds T, otherwise a copy of it converted to T.
+template <typename T, template <typename, size_t> typename TensorType, typename U, size_t Rank>
+auto convert_if_needed(const TensorType<U, Rank> &tensor) -> decltype(auto) {
+    if constexpr (std::is_same_v<T, U>) {
+        return tensor;
+    } else {
+        Tensor<T, Rank> result{tensor.dims()};
+        result.set_name(tensor.name());
+        result = tensor;
+        return result;
+    }
+}
+
 template <bool OnlyUseGenericAlgorithm, template <typename, size_t> typename AType, typename ADataType, size_t ARank,
           template <typename, size_t> typename BType, typename BDataType, size_t BRank, template <typename, size_t> typename CType,
-          typename CDataType, size_t CRank, typename... CIndices, typename... AIndices, typename... BIndices>
+          typename CDataType, size_t CRank, typename... CIndices, typename... AIndices, typename... BIndices,
+          typename Epilogue = NoEpilogue>
 auto einsum(const CDataType C_prefactor, const std::tuple<CIndices...> & /*Cs*/, CType<CDataType, CRank> *C,
             const std::conditional_t<(sizeof(ADataType) > sizeof(BDataType)), ADataType, BDataType> AB_prefactor,
             const std::tuple<AIndices...> & /*As*/, const AType<ADataType, ARank> &A, const std::tuple<BIndices...> & /*Bs*/,
-            const BType<BDataType, BRank> &B)
+            const BType<BDataType, BRank> &B, const Epilogue &epilogue = Epilogue{})
     -> std::enable_if_t<std::is_base_of_v<::einsums::detail::TensorBase<ADataType, ARank>, AType<ADataType, ARank>> &&
                         std::is_base_of_v<::einsums::detail::TensorBase<BDataType, BRank>, BType<BDataType, BRank>> &&
                         std::is_base_of_v<::einsums::detail::TensorBase<CDataType, CRank>, CType<CDataType, CRank>>> {
@@ -417,6 +1342,11 @@ auto einsum(const CDataType C_prefactor, const std::tuple<CIndices...> & /*Cs*/,
     // 4. Determine the links between CIndices and BIndices
     constexpr auto CBlinks = intersect_t<std::tuple<CIndices...>, std::tuple<BIndices...>>();
 
+    // 5. Determine the batch indices, those found in A, B, and C
+    constexpr auto batch = intersect_t<decltype(CAlinks), decltype(CBlinks)>();
+    constexpr auto CA_only = difference_t<decltype(CAlinks), decltype(batch)>();
+    constexpr auto CB_only = difference_t<decltype(CBlinks), decltype(batch)>();
+
     // Remove anything from A that exists in C
     constexpr auto CminusA = difference_t<std::tuple<CIndices...>, std::tuple<AIndices...>>();
     constexpr auto CminusB = difference_t<std::tuple<CIndices...>, std::tuple<BIndices...>>();
@@ -449,7 +1379,7 @@ auto einsum(const CDataType C_prefactor, const std::tuple<CIndices...> & /*Cs*/,
     constexpr auto B_target_position_in_C = detail::find_type_with_position(B_indices, C_indices);
 
     auto unique_target_dims = detail::get_dim_ranges_for(*C, detail::unique_find_type_with_position(C_unique, C_indices));
-    auto unique_link_dims = detail::get_dim_ranges_for(A, link_position_in_A);
+    auto unique_link_dims = detail::get_dim_ranges_for(A, detail::unique_find_type_with_position(link_unique, A_indices));
 
     constexpr auto contiguous_link_position_in_A = detail::contiguous_positions(link_position_in_A);
     constexpr auto contiguous_link_position_in_B = detail::contiguous_positions(link_position_in_B);
@@ -474,12 +1404,23 @@ auto einsum(const CDataType C_prefactor, const std::tuple<CIndices...> & /*Cs*/,
                                       contiguous_link_position_in_A && contiguous_link_position_in_B && contiguous_target_position_in_A &&
                                       contiguous_target_position_in_B && contiguous_A_targets_in_C && contiguous_B_targets_in_C &&
                                       same_ordering_link_position_in_AB && same_ordering_target_position_in_CA &&
-                                      same_ordering_target_position_in_CB && !A_hadamard_found && !B_hadamard_found && !C_hadamard_found;
+                                      same_ordering_target_position_in_CB && !A_hadamard_found && !B_hadamard_found && !C_hadamard_found &&
+                                      std::tuple_size_v<decltype(batch)> == 0;
     constexpr auto is_gemv_possible = contiguous_link_position_in_A && contiguous_link_position_in_B && contiguous_target_position_in_A &&
                                       same_ordering_link_position_in_AB && same_ordering_target_position_in_CA &&
                                       !same_ordering_target_position_in_CB && std::tuple_size_v<decltype(B_target_position_in_C)> == 0 &&
                                       !A_hadamard_found && !B_hadamard_found && !C_hadamard_found;
 
+    // Every index is either a batch index, a target of exactly one of A and B, or a link.
+    constexpr size_t batch_size = std::tuple_size_v<decltype(batch)>;
+    constexpr size_t CA_only_size = std::tuple_size_v<decltype(CA_only)>;
+    constexpr size_t CB_only_size = std::tuple_size_v<decltype(CB_only)>;
+    constexpr size_t links_size = std::tuple_size_v<decltype(links)>;
+    constexpr auto is_ttgt_possible = links_size != 0 && (batch_size != 0 || (CA_only_size != 0 && CB_only_size != 0)) &&
+                                      batch_size + CA_only_size + links_size == ARank && batch_size + links_size + CB_only_size == BRank &&
+                                      batch_size + CA_only_size + CB_only_size == CRank && !is_complex_v<CDataType> && !A_hadamard_found &&
+                                      !B_hadamard_found && !C_hadamard_found;
+
     constexpr auto element_wise_multiplication =
         C_exactly_matches_A && C_exactly_matches_B && !A_hadamard_found && !B_hadamard_found && !C_hadamard_found;
     constexpr auto dot_product =
@@ -561,19 +1502,69 @@ auto einsum(const CDataType C_prefactor, const std::tuple<CIndices...> & /*Cs*/,
     }
 #endif
 
+    // The strided loop nest needs direct access to the data and strides of every tensor.
+    constexpr auto is_strided_possible = !OnlyUseGenericAlgorithm && is_incore_rank_tensor_v<CType<CDataType, CRank>, CRank, CDataType> &&
+                                         is_incore_rank_tensor_v<AType<ADataType, ARank>, ARank, ADataType> &&
+                                         is_incore_rank_tensor_v<BType<BDataType, BRank>, BRank, BDataType>;
+
+    // An epilogue is applied as each element of C is stored where the algorithm allows it, and otherwise by
+    // finish_epilogue, right after the algorithm has written C.
+    constexpr bool has_epilogue = !std::is_same_v<Epilogue, NoEpilogue>;
+    auto finish_epilogue = [&]() {
+        if constexpr (has_epilogue)
+            apply_epilogue(epilogue, C);
+    };
+
     if constexpr (!std::is_same_v<CDataType, ADataType> || !std::is_same_v<CDataType, BDataType>) {
-        // Mixed datatypes go directly to the generic algorithm.
-        einsum_generic_algorithm(C_unique, A_unique, B_unique, link_unique, C_indices, A_indices, B_indices, unique_target_dims,
-                                 unique_link_dims, target_position_in_C, link_position_in_link, C_prefactor, C, AB_prefactor, A, B);
+        using ComputeType = mixed_compute_t<CDataType, ADataType, BDataType>;
+
+        // A contraction BLAS can do is run in a single type on converted copies of the operands. Converting costs a pass
+        // over each operand, which BLAS more than wins back. Anything else uses the strided or generic algorithm on the
+        // original operands.
+        if constexpr (is_strided_possible && (is_gemm_possible || is_gemv_possible || is_ttgt_possible) && CRank != 0 && ARank != 0 &&
+                      BRank != 0 && std::is_convertible_v<ComputeType, CDataType>) {
+            timer::push("mixed precision");
+            const auto &A_compute = convert_if_needed<ComputeType>(A);
+            const auto &B_compute = convert_if_needed<ComputeType>(B);
+            if constexpr (std::is_same_v<CDataType, ComputeType>) {
+                einsum<false>(C_prefactor, C_indices, C, static_cast<ComputeType>(AB_prefactor), A_indices, A_compute, B_indices,
+                              B_compute, epilogue);
+            } else {
+                Tensor<ComputeType, CRank> C_compute{C->dims()};
+                if (C_prefactor == CDataType{0})
+                    C_compute.zero();
+                else
+                    C_compute = *C;
+                einsum<false>(static_cast<ComputeType>(C_prefactor), C_indices, &C_compute, static_cast<ComputeType>(AB_prefactor),
+                              A_indices, A_compute, B_indices, B_compute, epilogue);
+
+                CDataType *c = C->data();
+                const ComputeType *c_compute = C_compute.data();
+                ::einsums::detail::make_loop_nest(*C, C_compute).parallel_for_each([&](const std::array<size_t, 2> &offset) {
+                    c[offset[0]] = static_cast<CDataType>(c_compute[offset[1]]);
+                });
+            }
+            timer::pop();
+        } else if constexpr (is_strided_possible) {
+            einsum_strided_algorithm(C_unique, link_unique, C_indices, A_indices, B_indices, C_prefactor, C, AB_prefactor, A, B,
+                                     epilogue);
+        } else {
+            einsum_generic_algorithm(C_unique, A_unique, B_unique, link_unique, C_indices, A_indices, B_indices, unique_target_dims,
+                                     unique_link_dims, target_position_in_C, link_position_in_link, C_prefactor, C, AB_prefactor, A, B);
+            finish_epilogue();
+        }
         return;
     } else if constexpr (dot_product) {
+        telemetry::detail::set_algorithm("dot");
         CDataType temp = linear_algebra::dot(A, B);
         (*C) *= C_prefactor;
         (*C) += AB_prefactor * temp;
+        finish_epilogue();
 
         return;
     } else if constexpr (element_wise_multiplication) {
         timer::Timer element_wise_multiplication{"element-wise multiplication"};
+        telemetry::detail::set_algorithm("element-wise");
 
         auto target_dims = get_dim_ranges<CRank>(*C);
         auto view = std::apply(ranges::views::cartesian_product, target_dims);
@@ -592,6 +1583,8 @@ auto einsum(const CDataType C_prefactor, const std::tuple<CIndices...> & /*Cs*/,
             CDataType &target_value = std::apply(*C, *it);
             ABDataType AB_product = std::apply(A, *it) * std::apply(B, *it);
             target_value = C_prefactor * target_value + AB_prefactor * AB_product;
+            if constexpr (has_epilogue)
+                target_value = std::apply([&](auto... i) { return epilogue(target_value, static_cast<size_t>(i)...); }, *it);
         }
 
         return;
@@ -633,19 +1626,23 @@ auto einsum(const CDataType C_prefactor, const std::tuple<CIndices...> & /*Cs*/,
                 break; // out of the do {} while(false) loop.
             }
             // If we got to this position, assume we successfully called ger.
+            telemetry::detail::set_algorithm("ger");
+            finish_epilogue();
             return;
         } while (false);
     } else if constexpr (!OnlyUseGenericAlgorithm) {
         do { // do {} while (false) trick to allow us to use a break below to "break" out of the loop.
             if constexpr (is_gemv_possible) {
+                constexpr bool transpose_A = std::get<1>(link_position_in_A) == 0;
+                constexpr size_t A_rows = transpose_A ? std::tuple_size_v<decltype(link_position_in_A)> / 2
+                                                      : std::tuple_size_v<decltype(target_position_in_A)> / 2;
 
-                if (!C->full_view_of_underlying() || !A.full_view_of_underlying() || !B.full_view_of_underlying()) {
+                // Views are handed to BLAS as they are when their strides allow it.
+                if (!is_blas_layout<A_rows>(A) || !is_blas_layout<0>(B) || !is_blas_layout<0>(*C)) {
                     // Fall through to generic algorithm.
                     break;
                 }
 
-                constexpr bool transpose_A = std::get<1>(link_position_in_A) == 0;
-
                 Dim<2> dA;
                 Dim<1> dB, dC;
                 Stride<2> sA;
@@ -682,22 +1679,31 @@ auto einsum(const CDataType C_prefactor, const std::tuple<CIndices...> & /*Cs*/,
                 } else {
                     linear_algebra::gemv<false>(AB_prefactor, tA, tB, C_prefactor, &tC);
                 }
-
+                telemetry::detail::set_algorithm("gemv");
+                finish_epilogue();
                 return;
             }
             // To use a gemm the input tensors need to be at least rank 2
             else if constexpr (CRank >= 2 && ARank >= 2 && BRank >= 2) {
                 if constexpr (!A_hadamard_found && !B_hadamard_found && !C_hadamard_found) {
                     if constexpr (is_gemm_possible) {
-
-                        if (!C->full_view_of_underlying() || !A.full_view_of_underlying() || !B.full_view_of_underlying()) {
+                        constexpr bool transpose_A = std::get<1>(link_position_in_A) == 0;
+                        constexpr bool transpose_B = std::get<1>(link_position_in_B) != 0;
+                        constexpr bool transpose_C = std::get<1>(A_target_position_in_C) != 0;
+                        constexpr size_t A_rows = transpose_A ? std::tuple_size_v<decltype(link_position_in_A)> / 2
+                                                              : std::tuple_size_v<decltype(target_position_in_A)> / 2;
+                        constexpr size_t B_rows = transpose_B ? std::tuple_size_v<decltype(target_position_in_B)> / 2
+                                                              : std::tuple_size_v<decltype(link_position_in_B)> / 2;
+                        constexpr size_t C_rows = transpose_C ? std::tuple_size_v<decltype(B_target_position_in_C)> / 2
+                                                              : std::tuple_size_v<decltype(A_target_position_in_C)> / 2;
+
+                        // Views are handed to BLAS as they are when their strides allow it.
+                        if (!is_blas_layout<A_rows>(A) || !is_blas_layout<B_rows>(B) || !is_blas_layout<C_rows>(*C)) {
                             // Fall through to generic algorithm.
                             break;
                         }
 
-                        constexpr bool transpose_A = std::get<1>(link_position_in_A) == 0;
-                        constexpr bool transpose_B = std::get<1>(link_position_in_B) != 0;
-                        constexpr bool transpose_C = std::get<1>(A_target_position_in_C) != 0;
+                        telemetry::detail::set_algorithm("gemm");
 
                         Dim<2> dA, dB, dC;
                         Stride<2> sA, sB, sC;
@@ -744,47 +1750,181 @@ auto einsum(const CDataType C_prefactor, const std::tuple<CIndices...> & /*Cs*/,
                         // println(tB);
                         // println("--------------------");
 
-                        if constexpr (!transpose_C && !transpose_A && !transpose_B) {
-                            linear_algebra::gemm<false, false>(AB_prefactor, tA, tB, C_prefactor, &tC);
-                            return;
-                        } else if constexpr (!transpose_C && !transpose_A && transpose_B) {
-                            linear_algebra::gemm<false, true>(AB_prefactor, tA, tB, C_prefactor, &tC);
-                            return;
-                        } else if constexpr (!transpose_C && transpose_A && !transpose_B) {
-                            linear_algebra::gemm<true, false>(AB_prefactor, tA, tB, C_prefactor, &tC);
-                            return;
-                        } else if constexpr (!transpose_C && transpose_A && transpose_B) {
-                            linear_algebra::gemm<true, true>(AB_prefactor, tA, tB, C_prefactor, &tC);
-                            return;
-                        } else if constexpr (transpose_C && !transpose_A && !transpose_B) {
-                            linear_algebra::gemm<true, true>(AB_prefactor, tB, tA, C_prefactor, &tC);
-                            return;
-                        } else if constexpr (transpose_C && !transpose_A && transpose_B) {
-                            linear_algebra::gemm<false, true>(AB_prefactor, tB, tA, C_prefactor, &tC);
-                            return;
-                        } else if constexpr (transpose_C && transpose_A && !transpose_B) {
-                            linear_algebra::gemm<true, false>(AB_prefactor, tB, tA, C_prefactor, &tC);
-                            return;
-                        } else if constexpr (transpose_C && transpose_A && transpose_B) {
-                            linear_algebra::gemm<false, false>(AB_prefactor, tB, tA, C_prefactor, &tC);
-                            return;
+                        // With C transposed, C^T = op(B)^T op(A)^T is computed instead.
+                        constexpr bool transpose_X = transpose_C ? !transpose_B : transpose_A;
+                        constexpr bool transpose_Y = transpose_C ? !transpose_A : transpose_B;
+                        const auto &X = std::get<transpose_C ? 1 : 0>(std::tie(tA, tB));
+                        const auto &Y = std::get<transpose_C ? 0 : 1>(std::tie(tA, tB));
+
+                        if constexpr (!has_epilogue) {
+                            linear_algebra::gemm<transpose_X, transpose_Y>(AB_prefactor, X, Y, C_prefactor, &tC);
                         } else {
-                            println("This GEMM case is not programmed: transpose_C {}, transpose_A {}, transpose_B {}", transpose_C,
-                                    transpose_A, transpose_B);
-                            std::abort();
+                            // C is computed in blocks of rows sized to L2, and the epilogue applied to each block before
+                            // the next one is computed. The rows of tC are the leading indices of C, so a block of rows
+                            // is a range of ordinals.
+                            const size_t rows = dC[0], columns = dC[1];
+                            const size_t block_bytes = ::einsums::detail::l2_cache_size() / 2;
+                            const size_t block = std::min(rows, std::max<size_t>(16, block_bytes / (columns * sizeof(CDataType))));
+                            for (size_t row = 0; row < rows; row += block) {
+                                const size_t count = std::min(block, rows - row);
+                                TensorView<CDataType, 2> bC{tC, Dim<2>{count, columns}, Offset<2>{row, 0}};
+                                if constexpr (transpose_X) {
+                                    const TensorView<CDataType, 2> bX{X, Dim<2>{X.dim(0), count}, Offset<2>{0, row}};
+                                    linear_algebra::gemm<transpose_X, transpose_Y>(AB_prefactor, bX, Y, C_prefactor, &bC);
+                                } else {
+                                    const TensorView<CDataType, 2> bX{X, Dim<2>{count, X.dim(1)}, Offset<2>{row, 0}};
+                                    linear_algebra::gemm<transpose_X, transpose_Y>(AB_prefactor, bX, Y, C_prefactor, &bC);
+                                }
+                                apply_epilogue(epilogue, C, row * columns, (row + count) * columns);
+                            }
                         }
+                        return;
                     }
                 }
             }
             // If we make it here, then none of our algorithms for this last block could be used.
             // Fall through to the generic algorithm below.
         } while (false);
+
+        // The indices are not grouped in a way that maps directly onto a single gemm. The contraction can still be
+        // performed by permuting the tensors first and looping over any batch indices.
+        if constexpr (is_ttgt_possible) {
+            if (einsum_ttgt_algorithm(batch, CA_only, links, CB_only, C_prefactor, C_indices, C, AB_prefactor, A_indices, A, B_indices,
+                                      B, epilogue)) {
+                telemetry::detail::set_algorithm("ttgt");
+                return;
+            }
+        }
     }
 
     // If we somehow make it here, then none of our algorithms above could be used. Attempt to use
     // the generic algorithm instead.
-    einsum_generic_algorithm(C_unique, A_unique, B_unique, link_unique, C_indices, A_indices, B_indices, unique_target_dims,
-                             unique_link_dims, target_position_in_C, link_position_in_link, C_prefactor, C, AB_prefactor, A, B);
+    if constexpr (is_strided_possible) {
+        einsum_strided_algorithm(C_unique, link_unique, C_indices, A_indices, B_indices, C_prefactor, C, AB_prefactor, A, B, epilogue);
+    } else {
+        einsum_generic_algorithm(C_unique, A_unique, B_unique, link_unique, C_indices, A_indices, B_indices, unique_target_dims,
+                                 unique_link_dims, target_position_in_C, link_position_in_link, C_prefactor, C, AB_prefactor, A, B);
+        finish_epilogue();
+    }
+}
+
+/// Extent of Index, taken from the first of C, A and B indexed by it.
+template <typename Index, typename... CIndices, typename... AIndices, typename... BIndices, typename CType, typename AType, typename BType>
+auto index_extent(const std::tuple<CIndices...> &, const CType &C, const std::tuple<AIndices...> &, const AType &A,
+                  const std::tuple<BIndices...> &, const BType &B) -> size_t {
+    if constexpr (find_position<Index, CIndices...>() >= 0)
+        return C.dim(find_position<Index, CIndices...>());
+    else if constexpr (find_position<Index, AIndices...>() >= 0)
+        return A.dim(find_position<Index, AIndices...>());
+    else
+        return B.dim(find_position<Index, BIndices...>());
+}
+
+/// Floating-point operations of a two-operand einsum: a multiply and an add for every combination of its indices.
+template <typename... UniqueIndices, typename... CIndices, typename... AIndices, typename... BIndices, typename CType, typename AType,
+          typename BType>
+auto einsum_flops(const std::tuple<UniqueIndices...> &, const std::tuple<CIndices...> &C_indices, const CType &C,
+                  const std::tuple<AIndices...> &A_indices, const AType &A, const std::tuple<BIndices...> &B_indices, const BType &B)
+    -> double {
+    return (2.0 * ... * static_cast<double>(index_extent<UniqueIndices>(C_indices, C, A_indices, A, B_indices, B)));
+}
+
+template <template <typename, size_t> typename TensorType, typename T, size_t Rank>
+auto element_count(const TensorType<T, Rank> &X) -> double {
+    double count{1};
+    for (size_t d = 0; d < Rank; d++)
+        count *= static_cast<double>(X.dim(d));
+    return count;
+}
+
+template <template <typename, size_t> typename TensorType, typename T, size_t Rank>
+auto telemetry_dims(const TensorType<T, Rank> &X) -> std::string {
+    std::vector<size_t> dims(Rank);
+    for (size_t d = 0; d < Rank; d++)
+        dims[d] = X.dim(d);
+    return fmt::format("{{{}}}", fmt::join(dims, ","));
+}
+
+/// Element of C at the given values of the unique indices of C.
+template <typename... CUniqueIndices, typename... CIndices, typename CType>
+auto target_element(const std::tuple<CUniqueIndices...> &, const std::tuple<CIndices...> &, const CType &C,
+                    const std::array<size_t, sizeof...(CUniqueIndices)> &target) {
+    return C(target[find_position<CIndices, CUniqueIndices...>()]...);
+}
+
+/// Up to count random values of the unique indices of C. Empty when count is zero or C has no more than count elements
+/// to choose from, in which case all of C is checked.
+template <typename... CUniqueIndices, typename... CIndices, typename CType>
+auto sample_targets(const std::tuple<CUniqueIndices...> &, const std::tuple<CIndices...> &, const CType &C, size_t count)
+    -> std::vector<std::array<size_t, sizeof...(CUniqueIndices)>> {
+    const std::array<size_t, sizeof...(CUniqueIndices)> dims{C.dim(find_position<CUniqueIndices, CIndices...>())...};
+    size_t elements{1};
+    for (size_t dim : dims)
+        elements *= dim;
+
+    std::vector<std::array<size_t, sizeof...(CUniqueIndices)>> samples;
+    if (count == 0 || count >= elements)
+        return samples;
+
+    static thread_local std::mt19937_64 engine{};
+    samples.resize(count);
+    for (auto &sample : samples) {
+        for (size_t d = 0; d < dims.size(); d++)
+            sample[d] = std::uniform_int_distribution<size_t>{0, dims[d] - 1}(engine);
+    }
+    return samples;
+}
+
+/// The value einsum gives the element of C at the given values of its unique indices, summing A * B directly over
+/// every index not in C. C_value is the element before the call.
+template <typename... CUniqueIndices, typename... CIndices, typename... AIndices, typename... BIndices, typename CType, typename AType,
+          typename BType, typename CDataType, typename ABDataType, typename Epilogue>
+auto einsum_element(const std::tuple<CUniqueIndices...> &, const std::array<size_t, sizeof...(CUniqueIndices)> &target,
+                    const CDataType C_prefactor, const CDataType C_value, const std::tuple<CIndices...> &C_indices, const CType &C,
+                    const ABDataType AB_prefactor, const std::tuple<AIndices...> &A_indices, const AType &A,
+                    const std::tuple<BIndices...> &B_indices, const BType &B, const Epilogue &epilogue) -> CDataType {
+    constexpr auto unique = c_unique_t<std::tuple<CIndices..., AIndices..., BIndices...>>();
+
+    return std::apply(
+        [&](auto... index) {
+            // Indices of C stay at the target; the others are swept from zero to their extent.
+            auto start = [&](auto i) -> size_t {
+                if constexpr (find_position<decltype(i), CUniqueIndices...>() >= 0)
+                    return target[find_position<decltype(i), CUniqueIndices...>()];
+                else
+                    return 0;
+            };
+            auto extent = [&](auto i) -> size_t {
+                if constexpr (find_position<decltype(i), CUniqueIndices...>() >= 0)
+                    return 1;
+                else
+                    return index_extent<decltype(i)>(C_indices, C, A_indices, A, B_indices, B);
+            };
+
+            std::array<size_t, sizeof...(index)> value{start(index)...};
+            const std::array<size_t, sizeof...(index)> first{value}, extents{extent(index)...};
+            size_t combinations{1};
+            for (size_t e : extents)
+                combinations *= e;
+
+            ABDataType sum{0};
+            for (size_t n = 0; n < combinations; n++) {
+                sum += A(value[find_position<AIndices, decltype(index)...>()]...) *
+                       B(value[find_position<BIndices, decltype(index)...>()]...);
+                for (size_t d = value.size(); d-- > 0;) {
+                    if (++value[d] - first[d] < extents[d])
+                        break;
+                    value[d] = first[d];
+                }
+            }
+
+            CDataType result = C_prefactor == CDataType{0} ? CDataType{0} : C_prefactor * C_value;
+            result += AB_prefactor * sum;
+            if constexpr (!std::is_same_v<Epilogue, NoEpilogue>)
+                result = epilogue(result, target[find_position<CIndices, CUniqueIndices...>()]...);
+            return result;
+        },
+        unique);
 }
 
 } // namespace detail
@@ -792,16 +1932,30 @@ auto einsum(const CDataType C_prefactor, const std::tuple<CIndices...> & /*Cs*/,
 /// FIXME: Hack for Andy. Remove this once his paper is completed. This is defined in Blas.cpp for now.
 extern bool einsum_raw_for_loop;
 
+/// With EINSUMS_CONTINUOUSLY_TEST_EINSUM, the number of elements of C each einsum recomputes directly from A and B to
+/// validate its result. Zero recomputes all of C with the generic algorithm and compares every element. Defaults to
+/// the EINSUMS_CONTINUOUSLY_TEST_EINSUM_SAMPLES setting.
+extern size_t einsum_test_samples;
+
+/**
+ * C = C_prefactor * C + AB_prefactor * A * B over the given indices.
+ *
+ * An optional epilogue replaces each element of C by epilogue(value, indices...), where indices are those of the element
+ * in C. It is applied while the result is still in cache, so a post-operation such as dividing a residual by
+ * orbital-energy denominators needs no second pass over C.
+ */
 template <template <typename, size_t> typename AType, typename ADataType, size_t ARank, template <typename, size_t> typename BType,
           typename BDataType, size_t BRank, template <typename, size_t> typename CType, typename CDataType, size_t CRank,
-          typename... CIndices, typename... AIndices, typename... BIndices, typename U>
+          typename... CIndices, typename... AIndices, typename... BIndices, typename U, typename Epilogue = detail::NoEpilogue>
 auto einsum(const U UC_prefactor, const std::tuple<CIndices...> &C_indices, CType<CDataType, CRank> *C, const U UAB_prefactor,
             const std::tuple<AIndices...> &A_indices, const AType<ADataType, ARank> &A, const std::tuple<BIndices...> &B_indices,
-            const BType<BDataType, BRank> &B)
+            const BType<BDataType, BRank> &B, const Epilogue &epilogue = Epilogue{})
     -> std::enable_if_t<std::is_base_of_v<::einsums::detail::TensorBase<ADataType, ARank>, AType<ADataType, ARank>> &&
                         std::is_base_of_v<::einsums::detail::TensorBase<BDataType, BRank>, BType<BDataType, BRank>> &&
                         std::is_base_of_v<::einsums::detail::TensorBase<CDataType, CRank>, CType<CDataType, CRank>> &&
-                        std::is_arithmetic_v<U>> {
+                        !is_ondisk_tensor_v<AType<ADataType, ARank>, ARank, ARank, ADataType> &&
+                        !is_ondisk_tensor_v<BType<BDataType, BRank>, BRank, BRank, BDataType> &&
+                        !is_ondisk_tensor_v<CType<CDataType, CRank>, CRank, CRank, CDataType> && std::is_arithmetic_v<U>> {
     using ABDataType = std::conditional_t<(sizeof(ADataType) > sizeof(BDataType)), ADataType, BDataType>;
 
     Section section(FP_ZERO != std::fpclassify(UC_prefactor)
@@ -815,74 +1969,122 @@ auto einsum(const U UC_prefactor, const std::tuple<CIndices...> &C_indices, CTyp
     const ABDataType AB_prefactor = UAB_prefactor;
 
 #if defined(EINSUMS_CONTINUOUSLY_TEST_EINSUM)
-    // Clone C into a new tensor
-    Tensor<CDataType, CRank> testC{C->dims()};
-    testC = *C;
+    // Either a sample of the elements of C is recomputed once the einsum is done, or all of C is computed up front by
+    // the generic algorithm.
+    constexpr auto C_unique = c_unique_t<std::tuple<CIndices...>>();
+    const auto samples = detail::sample_targets(C_unique, C_indices, *C, einsum_test_samples);
+    const bool sampled = !samples.empty();
 
-    // Perform the einsum using only the generic algorithm
-    timer::push("testing");
-    detail::einsum<true>(C_prefactor, C_indices, &testC, AB_prefactor, A_indices, A, B_indices, B);
-    timer::pop();
-#endif
+    std::vector<CDataType> sampled_before(samples.size());
+    for (size_t n = 0; n < samples.size(); n++)
+        sampled_before[n] = detail::target_element(C_unique, C_indices, *C, samples[n]);
 
-    // Perform the actual einsum
-    /// FIXME: Remove once Andy's paper is completed.
-    if (einsum_raw_for_loop)
-        detail::einsum<true>(C_prefactor, C_indices, C, AB_prefactor, A_indices, A, B_indices, B);
-    else
-        detail::einsum<false>(C_prefactor, C_indices, C, AB_prefactor, A_indices, A, B_indices, B);
+    // Clone C into a new tensor
+    Tensor<CDataType, CRank> testC{sampled ? Dim<CRank>{} : C->dims()};
+    if (!sampled) {
+        testC = *C;
+
+        // Perform the einsum using only the generic algorithm
+        timer::push("testing");
+        detail::einsum<true>(C_prefactor, C_indices, &testC, AB_prefactor, A_indices, A, B_indices, B, epilogue);
+        timer::pop();
+    }
+#endif
 
+    // With an epilogue, EINSUMS_TEST_NANS checks each element of C as the epilogue stores it, rather than scanning C
+    // afterwards.
 #if defined(EINSUMS_TEST_NANS)
-    if constexpr (CRank != 0) {
-        auto target_dims = get_dim_ranges<CRank>(*C);
-        for (auto target_combination : std::apply(ranges::views::cartesian_product, target_dims)) {
-            CDataType Cvalue{std::apply(*C, target_combination)};
-            if constexpr (!is_complex_v<CDataType>) {
-                if (std::isnan(Cvalue)) {
-                    println(bg(fmt::color::red) | fg(fmt::color::white), "NaN DETECTED!");
-                    println(bg(fmt::color::red) | fg(fmt::color::white), "    {:f} {}({:}) += {:f} {}({:}) * {}({:})", C_prefactor,
-                            C->name(), print_tuple_no_type(C_indices), AB_prefactor, A.name(), print_tuple_no_type(A_indices), B.name(),
-                            print_tuple_no_type(B_indices));
+    constexpr bool check_in_epilogue = !std::is_same_v<Epilogue, detail::NoEpilogue> && CRank != 0 && !is_complex_v<CDataType>;
+#else
+    constexpr bool check_in_epilogue = false;
+#endif
+    std::atomic<bool> suspicious{false};
+
+    {
+#if defined(EINSUMS_TELEMETRY)
+        // Flops count every combination of the indices, bytes a read of A and B and a read and write of C.
+        telemetry::detail::Call call{
+            fmt::format(R"("{}"{} = "{}"{} * "{}"{})", C->name(), print_tuple_no_type(C_indices), A.name(), print_tuple_no_type(A_indices),
+                        B.name(), print_tuple_no_type(B_indices)),
+            fmt::format("{} {} {}", detail::telemetry_dims(*C), detail::telemetry_dims(A), detail::telemetry_dims(B)),
+            detail::einsum_flops(c_unique_t<std::tuple<CIndices..., AIndices..., BIndices...>>(), C_indices, *C, A_indices, A, B_indices,
+                                 B),
+            2 * detail::element_count(*C) * sizeof(CDataType) + detail::element_count(A) * sizeof(ADataType) +
+                detail::element_count(B) * sizeof(BDataType)};
+#endif
 
-                    println(*C);
-                    println(A);
-                    println(B);
+        // Perform the actual einsum
+        /// FIXME: Remove once Andy's paper is completed.
+        auto perform = [&](const auto &final_epilogue) {
+            if (einsum_raw_for_loop)
+                detail::einsum<true>(C_prefactor, C_indices, C, AB_prefactor, A_indices, A, B_indices, B, final_epilogue);
+            else
+                detail::einsum<false>(C_prefactor, C_indices, C, AB_prefactor, A_indices, A, B_indices, B, final_epilogue);
+        };
+
+        if constexpr (check_in_epilogue)
+            perform(detail::CheckedEpilogue<Epilogue>{epilogue, &suspicious});
+        else
+            perform(epilogue);
+    }
 
-                    throw std::runtime_error("NAN detected in resulting tensor.");
-                }
+#if defined(EINSUMS_TEST_NANS)
+    if constexpr (CRank != 0 && !is_complex_v<CDataType>) {
+        bool found;
+        if constexpr (check_in_epilogue)
+            found = suspicious.load();
+        else
+            found = detail::has_suspicious_values(*C);
+
+        if (found) {
+            const auto kind = detail::classify_suspicious_values(*C);
+            const char *what = kind == detail::SuspiciousValue::NaN        ? "NaN"
+                               : kind == detail::SuspiciousValue::Infinity ? "Infinity"
+                                                                           : "Large value";
+            println(bg(fmt::color::red) | fg(fmt::color::white), "{} DETECTED!", what);
+            println(bg(fmt::color::red) | fg(fmt::color::white), "    {:f} {}({:}) += {:f} {}({:}) * {}({:})", C_prefactor, C->name(),
+                    print_tuple_no_type(C_indices), AB_prefactor, A.name(), print_tuple_no_type(A_indices), B.name(),
+                    print_tuple_no_type(B_indices));
 
-                if (std::isinf(Cvalue)) {
-                    println(bg(fmt::color::red) | fg(fmt::color::white), "Infinity DETECTED!");
-                    println(bg(fmt::color::red) | fg(fmt::color::white), "    {:f} {}({:}) += {:f} {}({:}) * {}({:})", C_prefactor,
-                            C->name(), print_tuple_no_type(C_indices), AB_prefactor, A.name(), print_tuple_no_type(A_indices), B.name(),
-                            print_tuple_no_type(B_indices));
+            println(*C);
+            println(A);
+            println(B);
 
-                    println(*C);
-                    println(A);
-                    println(B);
+            throw std::runtime_error(fmt::format("{} detected in resulting tensor.", what));
+        }
+    }
+#endif
 
-                    throw std::runtime_error("Infinity detected in resulting tensor.");
-                }
+#if defined(EINSUMS_CONTINUOUSLY_TEST_EINSUM)
+    if (sampled) {
+        timer::Timer testing{"testing"};
+        for (size_t n = 0; n < samples.size(); n++) {
+            const CDataType Cvalue = detail::target_element(C_unique, C_indices, *C, samples[n]);
+            const CDataType Ctest = detail::einsum_element(C_unique, samples[n], C_prefactor, sampled_before[n], C_indices, *C,
+                                                           AB_prefactor, A_indices, A, B_indices, B, epilogue);
 
-                if (std::abs(Cvalue) > 100000000) {
-                    println(bg(fmt::color::red) | fg(fmt::color::white), "Large value DETECTED!");
-                    println(bg(fmt::color::red) | fg(fmt::color::white), "    {:f} {}({:}) += {:f} {}({:}) * {}({:})", C_prefactor,
-                            C->name(), print_tuple_no_type(C_indices), AB_prefactor, A.name(), print_tuple_no_type(A_indices), B.name(),
-                            print_tuple_no_type(B_indices));
+#if defined(EINSUMS_USE_CATCH2)
+            if constexpr (!is_complex_v<CDataType>) {
+                REQUIRE_THAT(Cvalue,
+                             Catch::Matchers::WithinRel(Ctest, static_cast<CDataType>(0.001)) || Catch::Matchers::WithinAbs(0, 0.0001));
+            }
+#endif
 
-                    println(*C);
-                    println(A);
-                    println(B);
+            if (std::abs(Cvalue - Ctest) > 1.0E-6) {
+                println(emphasis::bold | bg(fmt::color::red) | fg(fmt::color::white), "    !!! EINSUM ERROR !!!");
+                println(bg(fmt::color::red) | fg(fmt::color::white), "    Expected {:20.14f}", Ctest);
+                println(bg(fmt::color::red) | fg(fmt::color::white), "    Obtained {:20.14f}", Cvalue);
 
-                    throw std::runtime_error("Large value detected in resulting tensor.");
-                }
+                println(bg(fmt::color::red) | fg(fmt::color::white), "    sampled unique indices of C ({})",
+                        fmt::join(samples[n], ", "));
+                println(bg(fmt::color::red) | fg(fmt::color::white), "    {:f} C({:}) += {:f} A({:}) * B({:})", C_prefactor,
+                        print_tuple_no_type(C_indices), AB_prefactor, print_tuple_no_type(A_indices), print_tuple_no_type(B_indices));
+#if defined(EINSUMS_TEST_EINSUM_ABORT)
+                std::abort();
+#endif
             }
         }
-    }
-#endif
-
-#if defined(EINSUMS_CONTINUOUSLY_TEST_EINSUM)
-    if constexpr (CRank != 0) {
+    } else if constexpr (CRank != 0) {
         // Need to walk through the entire C and testC comparing values and reporting differences.
         auto target_dims = get_dim_ranges<CRank>(*C);
         bool print_info_and_abort{false};
@@ -958,6 +2160,229 @@ auto einsum(const U UC_prefactor, const std::tuple<CIndices...> &C_indices, CTyp
 #endif
 }
 
+/// Memory, in bytes, the tiles an out-of-core einsum holds of its operands on disk may take together. Defaults to 1 GiB.
+extern size_t einsum_disk_memory_limit;
+
+namespace detail {
+
+/// Position in Unique of each of the indices of a tensor.
+template <typename... Unique, typename... XIndices>
+constexpr auto index_positions(const std::tuple<Unique...> &, const std::tuple<XIndices...> &) -> std::array<size_t, sizeof...(XIndices)> {
+    return {static_cast<size_t>(find_position<XIndices, Unique...>())...};
+}
+
+/**
+ * Tiles of an operand of an out-of-core einsum. A tile of a DiskTensor is read as one hyperslab and kept until a
+ * different tile is asked for; a tile of an in-core tensor is a view of it.
+ */
+template <template <typename, size_t> typename XType, typename T, size_t Rank>
+struct OutOfCoreOperand {
+    static constexpr bool on_disk = is_ondisk_tensor_v<XType<T, Rank>, Rank, Rank, T>;
+
+    const XType<T, Rank> &X;
+    Tensor<T, Rank> tile{};
+    Offset<Rank> offsets{};
+    Count<Rank> counts{};
+    bool loaded{false};
+
+    auto get(const Offset<Rank> &next_offsets, const Count<Rank> &next_counts)
+        -> std::conditional_t<on_disk, const Tensor<T, Rank> &, TensorView<T, Rank>> {
+        Dim<Rank> dims;
+        std::copy(next_counts.begin(), next_counts.end(), dims.begin());
+        if constexpr (on_disk) {
+            if (!loaded || next_offsets != offsets || next_counts != counts) {
+                if (!loaded || next_counts != counts) {
+                    tile = Tensor<T, Rank>{dims};
+                    tile.set_name(X.name());
+                }
+                h5::read<T>(const_cast<XType<T, Rank> &>(X).disk(), tile.data(), h5::count{next_counts}, h5::offset{next_offsets});
+                offsets = next_offsets;
+                counts = next_counts;
+                loaded = true;
+            }
+            return tile;
+        } else {
+            return TensorView<T, Rank>{X, dims, next_offsets};
+        }
+    }
+};
+
+} // namespace detail
+
+/**
+ * Einsum with DiskTensor operands or output, or both, run tile by tile within einsum_disk_memory_limit.
+ *
+ * Of A and B, the outer operand is the one on disk, or the larger if both are. The index space is cut into tiles by
+ * halving the longest index of C until the tiles of the tensors on disk fit the limit, on a tie the indices only the
+ * other operand has first. The contracted indices are halved only once every index of C is down to one. Each tile of A
+ * and B on disk is read as a hyperslab and contracted in core by einsum. The tiles of C are kept while every tile of the
+ * contracted indices is added to them and then written once.
+ *
+ * The indices of C that the outer operand has are looped over outermost and the contracted indices innermost. While
+ * the contracted indices fit in one tile, the outer operand is then read once in all, and the other operand once per
+ * tile of the outer operand. When they have to be split, both are read again for every tile of C.
+ */
+template <template <typename, size_t> typename AType, template <typename, size_t> typename BType,
+          template <typename, size_t> typename CType, typename T, size_t ARank, size_t BRank, size_t CRank, typename... CIndices,
+          typename... AIndices, typename... BIndices, typename U>
+auto einsum(const U UC_prefactor, const std::tuple<CIndices...> &C_indices, CType<T, CRank> *C, const U UAB_prefactor,
+            const std::tuple<AIndices...> &A_indices, const AType<T, ARank> &A, const std::tuple<BIndices...> &B_indices,
+            const BType<T, BRank> &B)
+    -> std::enable_if_t<std::is_arithmetic_v<U> &&
+                        (is_ondisk_tensor_v<AType<T, ARank>, ARank, ARank, T> || is_ondisk_tensor_v<BType<T, BRank>, BRank, BRank, T> ||
+                         is_ondisk_tensor_v<CType<T, CRank>, CRank, CRank, T>) &&
+                        (is_ondisk_tensor_v<AType<T, ARank>, ARank, ARank, T> || is_incore_rank_tensor_v<AType<T, ARank>, ARank, T>) &&
+                        (is_ondisk_tensor_v<BType<T, BRank>, BRank, BRank, T> || is_incore_rank_tensor_v<BType<T, BRank>, BRank, T>) &&
+                        (is_ondisk_tensor_v<CType<T, CRank>, CRank, CRank, T> || is_incore_rank_tensor_v<CType<T, CRank>, CRank, T>)> {
+    static_assert(CRank > 0, "einsum: an out-of-core einsum needs a C of rank one or more");
+
+    Section section{fmt::format(R"(einsum: out of core "{}"{} = "{}"{} * "{}"{})", C->name(), print_tuple_no_type(C_indices), A.name(),
+                                print_tuple_no_type(A_indices), B.name(), print_tuple_no_type(B_indices))};
+
+    constexpr bool C_on_disk = is_ondisk_tensor_v<CType<T, CRank>, CRank, CRank, T>;
+    const T C_prefactor = UC_prefactor;
+    const T AB_prefactor = UAB_prefactor;
+
+    using Unique = c_unique_t<std::tuple<CIndices..., AIndices..., BIndices...>>;
+    constexpr size_t UniqueRank = std::tuple_size_v<Unique>;
+    constexpr auto C_position = detail::index_positions(Unique{}, std::tuple<CIndices...>{});
+    constexpr auto A_position = detail::index_positions(Unique{}, std::tuple<AIndices...>{});
+    constexpr auto B_position = detail::index_positions(Unique{}, std::tuple<BIndices...>{});
+
+    std::array<size_t, UniqueRank> extent{};
+    for_sequence<UniqueRank>([&](auto u) {
+        extent[u] = detail::index_extent<std::tuple_element_t<u, Unique>>(C_indices, *C, A_indices, A, B_indices, B);
+    });
+    auto check = [&](const auto &X, const auto &position) {
+        for (size_t d = 0; d < position.size(); d++) {
+            if (X.dim(d) != extent[position[d]])
+                throw std::runtime_error(fmt::format("einsum: dimension {} of {} does not match the other tensors", d, X.name()));
+        }
+    };
+    check(*C, C_position);
+    check(A, A_position);
+    check(B, B_position);
+
+    // Indices of C that the outer operand has come first, then those only the other operand has, then the contracted
+    // indices.
+    constexpr bool A_on_disk = is_ondisk_tensor_v<AType<T, ARank>, ARank, ARank, T>;
+    constexpr bool B_on_disk = is_ondisk_tensor_v<BType<T, BRank>, BRank, BRank, T>;
+    const bool A_is_outer = A_on_disk != B_on_disk ? A_on_disk : detail::element_count(A) >= detail::element_count(B);
+    std::array<int, UniqueRank> group{};
+    for_sequence<UniqueRank>([&](auto u) {
+        using Index = std::tuple_element_t<u, Unique>;
+        const bool in_A = detail::find_position<Index, AIndices...>() >= 0;
+        const bool in_B = detail::find_position<Index, BIndices...>() >= 0;
+        if (detail::find_position<Index, CIndices...>() < 0)
+            group[u] = 2;
+        else
+            group[u] = (A_is_outer ? in_A : in_B) ? 0 : 1;
+    });
+
+    std::array<size_t, UniqueRank> tile{extent};
+    auto tile_bytes = [&](const auto &position, bool on_disk) {
+        double elements = on_disk ? 1.0 : 0.0;
+        for (size_t p : position)
+            elements *= static_cast<double>(tile[p]);
+        return elements * sizeof(T);
+    };
+    auto footprint = [&]() {
+        return tile_bytes(A_position, A_on_disk) + tile_bytes(B_position, B_on_disk) + tile_bytes(C_position, C_on_disk);
+    };
+    while (footprint() > static_cast<double>(einsum_disk_memory_limit)) {
+        // Splitting the contracted indices would make the tile of the outer operand change with the inner loop.
+        size_t longest = UniqueRank;
+        for (const bool contracted : {false, true}) {
+            for (size_t u = 0; u < UniqueRank; u++) {
+                if ((group[u] == 2) != contracted || tile[u] == 1)
+                    continue;
+                if (longest == UniqueRank || tile[u] > tile[longest] || (tile[u] == tile[longest] && group[u] > group[longest]))
+                    longest = u;
+            }
+            if (longest != UniqueRank)
+                break;
+        }
+        if (longest == UniqueRank)
+            break;
+        tile[longest] = (tile[longest] + 1) / 2;
+    }
+
+    std::array<size_t, UniqueRank> order{};
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t x, size_t y) { return group[x] < group[y]; });
+
+    detail::OutOfCoreOperand<AType, T, ARank> A_tiles{A};
+    detail::OutOfCoreOperand<BType, T, BRank> B_tiles{B};
+    Tensor<T, CRank> C_tile{};
+
+    std::array<size_t, UniqueRank> start{};
+    auto slab = [&](const auto &position, auto *offsets, auto *counts) {
+        for (size_t d = 0; d < position.size(); d++) {
+            (*offsets)[d] = start[position[d]];
+            (*counts)[d] = std::min(tile[position[d]], extent[position[d]] - start[position[d]]);
+        }
+    };
+    auto at_first_link_tile = [&]() {
+        for (size_t u = 0; u < UniqueRank; u++) {
+            if (group[u] == 2 && start[u] != 0)
+                return false;
+        }
+        return true;
+    };
+
+    bool done{false};
+    while (!done) {
+        const bool first_link_tile = at_first_link_tile();
+        Offset<CRank> C_offsets;
+        Count<CRank> C_counts;
+        Offset<ARank> A_offsets;
+        Count<ARank> A_counts;
+        Offset<BRank> B_offsets;
+        Count<BRank> B_counts;
+        slab(C_position, &C_offsets, &C_counts);
+        slab(A_position, &A_offsets, &A_counts);
+        slab(B_position, &B_offsets, &B_counts);
+
+        Dim<CRank> C_dims;
+        std::copy(C_counts.begin(), C_counts.end(), C_dims.begin());
+        const T prefactor = first_link_tile ? C_prefactor : T{1};
+        if constexpr (C_on_disk) {
+            if (first_link_tile) {
+                C_tile = Tensor<T, CRank>{C_dims};
+                C_tile.set_name(C->name());
+                if (C_prefactor == T{0})
+                    C_tile.zero();
+                else
+                    h5::read<T>(C->disk(), C_tile.data(), h5::count{C_counts}, h5::offset{C_offsets});
+            }
+            einsum(prefactor, C_indices, &C_tile, AB_prefactor, A_indices, A_tiles.get(A_offsets, A_counts), B_indices,
+                   B_tiles.get(B_offsets, B_counts));
+        } else {
+            TensorView<T, CRank> C_view{*C, C_dims, C_offsets};
+            einsum(prefactor, C_indices, &C_view, AB_prefactor, A_indices, A_tiles.get(A_offsets, A_counts), B_indices,
+                   B_tiles.get(B_offsets, B_counts));
+        }
+
+        // The innermost index in order moves fastest.
+        size_t level = UniqueRank;
+        while (level > 0) {
+            const size_t u = order[level - 1];
+            start[u] += tile[u];
+            if (start[u] < extent[u])
+                break;
+            start[u] = 0;
+            level--;
+        }
+        done = level == 0;
+
+        // Every contracted tile has been added to this tile of C once the contracted indices wrap around.
+        if constexpr (C_on_disk) {
+            if (at_first_link_tile())
+                h5::write<T>(C->disk(), C_tile.data(), h5::count{C_counts}, h5::offset{C_offsets});
+        }
+    }
+}
+
 // Einsums with provided prefactors.
 // 1. C n A n B n is defined above as the base implementation.
 
@@ -1029,6 +2454,15 @@ auto einsum(const std::tuple<CIndices...> &C_indices, CType *C, const std::tuple
     einsum(0, C_indices, C, 1, A_indices, A, B_indices, B);
 }
 
+// 1a. C n A n B n with an epilogue
+template <typename AType, typename BType, typename CType, typename... CIndices, typename... AIndices, typename... BIndices,
+          typename Epilogue>
+auto einsum(const std::tuple<CIndices...> &C_indices, CType *C, const std::tuple<AIndices...> &A_indices, const AType &A,
+            const std::tuple<BIndices...> &B_indices, const BType &B, const Epilogue &epilogue)
+    -> std::enable_if_t<!is_smart_pointer_v<CType> && !is_smart_pointer_v<AType> && !is_smart_pointer_v<BType>> {
+    einsum(0, C_indices, C, 1, A_indices, A, B_indices, B, epilogue);
+}
+
 // 2. C n A n B y
 template <typename AType, typename BType, typename CType, typename... CIndices, typename... AIndices, typename... BIndices>
 auto einsum(const std::tuple<CIndices...> &C_indices, CType *C, const std::tuple<AIndices...> &A_indices, const AType &A,
@@ -1086,99 +2520,522 @@ auto einsum(const std::tuple<CIndices...> &C_indices, CType *C, const std::tuple
 }
 
 //
-// sort algorithm
+// Single-operand einsum
 //
+
+namespace detail {
+
+/// Shape of a single-operand einsum, decided from its indices alone. A trace is a reduction to a rank-0 C.
+enum class UnaryEinsumKind { Permutation, Diagonal, Reduction, Trace };
+
+template <typename CIndices, typename AIndices>
+constexpr auto unary_einsum_kind() -> UnaryEinsumKind {
+    using AUnique = c_unique_t<AIndices>;
+    if constexpr (std::tuple_size_v<CIndices> == 0)
+        return UnaryEinsumKind::Trace;
+    else if constexpr (std::tuple_size_v<difference_t<AUnique, CIndices>> != 0)
+        return UnaryEinsumKind::Reduction;
+    else if constexpr (std::tuple_size_v<AUnique> != std::tuple_size_v<AIndices>)
+        return UnaryEinsumKind::Diagonal;
+    else
+        return UnaryEinsumKind::Permutation;
+}
+
+/**
+ * Sums A over the loops of link into each element of C. target walks C and A together; link walks the summed indices
+ * of A.
+ *
+ * When C is small next to the summation, as in a trace, the summation is split between threads, each accumulating
+ * into its own partial sums, which are added together at the end. Otherwise each thread owns a range of C and sums into
+ * it directly, with the loop over A's most contiguous index innermost.
+ */
+template <size_t TargetRank, size_t LinkRank, typename T>
+void einsum_reduction_kernel(const ::einsums::detail::LoopNest<TargetRank, 2> &target, const ::einsums::detail::LoopNest<LinkRank, 1> &link,
+                             const T C_prefactor, T *c, const T A_prefactor, const T *a) {
+    using TargetOffsets = std::array<size_t, 2>;
+    using LinkOffsets = std::array<size_t, 1>;
+
+    const size_t targets = target.size();
+    const size_t links = link.size();
+
+    // As in BLAS, C is not read when C_prefactor is zero, so it may be uninitialized.
+    auto update = [&](T &c_value, const T sum) {
+        c_value = C_prefactor == T{0} ? A_prefactor * sum : C_prefactor * c_value + A_prefactor * sum;
+    };
+
+    if (TargetRank == 0 || (targets < links && targets * sizeof(T) <= ::einsums::detail::l2_cache_size())) {
+        std::vector<TargetOffsets> offsets;
+        offsets.reserve(targets);
+        target.for_each(0, targets, [&](const TargetOffsets &offset) { offsets.push_back(offset); });
+
+        std::vector<T> sums(targets, T{0});
+#pragma omp parallel
+        {
+            const size_t threads = omp_get_num_threads();
+            const size_t thread = omp_get_thread_num();
+            const size_t chunk = (links + threads - 1) / threads;
+            const size_t begin = std::min(links, thread * chunk);
+            const size_t end = std::min(links, begin + chunk);
+
+            std::vector<T> partial(targets, T{0});
+            link.for_each_run(begin, end, [&](const LinkOffsets &l, size_t count, const LinkOffsets &step) {
+                for (size_t t = 0; t < targets; t++) {
+                    const T *a_run = a + offsets[t][1] + l[0];
+                    T sum{0};
+                    for (size_t i = 0; i < count; i++)
+                        sum += a_run[i * step[0]];
+                    partial[t] += sum;
+                }
+            });
+
+#pragma omp critical
+            for (size_t t = 0; t < targets; t++)
+                sums[t] += partial[t];
+        }
+
+        for (size_t t = 0; t < targets; t++)
+            update(c[offsets[t][0]], sums[t]);
+        return;
+    }
+
+    if constexpr (TargetRank != 0) {
+        if (LinkRank != 0 && link.steps[LinkRank - 1][0] < target.steps[TargetRank - 1][1]) {
+            // A is more contiguous along the summation: each element of C is a strided sum over the link loops.
+            target.parallel_for_each([&](const TargetOffsets &offset) {
+                T sum{0};
+                link.for_each_run(0, links, [&](const LinkOffsets &l, size_t count, const LinkOffsets &step) {
+                    const T *a_run = a + offset[1] + l[0];
+                    for (size_t i = 0; i < count; i++)
+                        sum += a_run[i * step[0]];
+                });
+                update(c[offset[0]], sum);
+            });
+        } else {
+            // A is more contiguous along C: sweep a range of C once for each element of the summation.
+            target.parallel_for_each_run([&](const TargetOffsets &offset, size_t count, const TargetOffsets &step) {
+                T *c_run = c + offset[0];
+                if (C_prefactor == T{0}) {
+                    for (size_t i = 0; i < count; i++)
+                        c_run[i * step[0]] = T{0};
+                } else if (C_prefactor != T{1}) {
+                    for (size_t i = 0; i < count; i++)
+                        c_run[i * step[0]] *= C_prefactor;
+                }
+            });
+#pragma omp parallel
+            {
+                const size_t threads = omp_get_num_threads();
+                const size_t thread = omp_get_thread_num();
+                const size_t chunk = (targets + threads - 1) / threads;
+                const size_t begin = std::min(targets, thread * chunk);
+                const size_t end = std::min(targets, begin + chunk);
+
+                link.for_each(0, links, [&](const LinkOffsets &l) {
+                    target.for_each_run(begin, end, [&](const TargetOffsets &offset, size_t count, const TargetOffsets &step) {
+                        T *c_run = c + offset[0];
+                        const T *a_run = a + offset[1] + l[0];
+                        for (size_t i = 0; i < count; i++)
+                            c_run[i * step[0]] += A_prefactor * a_run[i * step[1]];
+                    });
+                });
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * C = C_prefactor * C + A_prefactor * A over the given indices, for the operations that need a single operand:
+ * permutations (C_ji = A_ij), diagonals (C_i = A_ii), partial sums (C_ij = sum_k A_ikj) and traces (c = A_ijij).
+ * Indices of A missing from C are summed over; indices repeated in A select its diagonal.
+ *
+ * Permutations go to sort; the others run in a strided kernel chosen from the indices at compile time.
+ */
 template <template <typename, size_t> typename AType, size_t ARank, template <typename, size_t> typename CType, size_t CRank,
           typename... CIndices, typename... AIndices, typename U, typename T = double>
-auto sort(const U UC_prefactor, const std::tuple<CIndices...> &C_indices, CType<T, CRank> *C, const U UA_prefactor,
-          const std::tuple<AIndices...> &A_indices, const AType<T, ARank> &A)
+auto einsum(const U UC_prefactor, const std::tuple<CIndices...> &C_indices, CType<T, CRank> *C, const U UA_prefactor,
+            const std::tuple<AIndices...> &A_indices, const AType<T, ARank> &A)
     -> std::enable_if_t<std::is_base_of_v<::einsums::detail::TensorBase<T, CRank>, CType<T, CRank>> &&
-                        std::is_base_of_v<::einsums::detail::TensorBase<T, ARank>, AType<T, ARank>> &&
-                        sizeof...(CIndices) == sizeof...(AIndices) && sizeof...(CIndices) == CRank && sizeof...(AIndices) == ARank &&
-                        std::is_arithmetic_v<U>> {
+                        std::is_base_of_v<::einsums::detail::TensorBase<T, ARank>, AType<T, ARank>> && std::is_arithmetic_v<U>> {
+    static_assert(sizeof...(CIndices) == CRank, "Rank of C does not match Indices given for C.");
+    static_assert(sizeof...(AIndices) == ARank, "Rank of A does not match Indices given for A.");
+    static_assert(std::tuple_size_v<c_unique_t<std::tuple<CIndices...>>> == CRank, "Indices of C must be distinct.");
+    static_assert(std::tuple_size_v<difference_t<std::tuple<CIndices...>, std::tuple<AIndices...>>> == 0,
+                  "Every index of C must appear in A.");
 
-    Section section{FP_ZERO != std::fpclassify(UC_prefactor)
-                        ? fmt::format(R"(sort: "{}"{} = {} "{}"{} + {} "{}"{})", C->name(), print_tuple_no_type(C_indices), UA_prefactor,
-                                      A.name(), print_tuple_no_type(A_indices), UC_prefactor, C->name(), print_tuple_no_type(C_indices))
-                        : fmt::format(R"(sort: "{}"{} = {} "{}"{})", C->name(), print_tuple_no_type(C_indices), UA_prefactor, A.name(),
-                                      print_tuple_no_type(A_indices))};
+    constexpr auto kind = detail::unary_einsum_kind<std::tuple<CIndices...>, std::tuple<AIndices...>>();
 
-    const T C_prefactor = UC_prefactor;
-    const T A_prefactor = UA_prefactor;
+    if constexpr (kind == detail::UnaryEinsumKind::Permutation) {
+        sort(UC_prefactor, C_indices, C, UA_prefactor, A_indices, A);
+    } else {
+        Section section{FP_ZERO != std::fpclassify(UC_prefactor)
+                            ? fmt::format(R"(einsum: "{}"{} = {} "{}"{} + {} "{}"{})", C->name(), print_tuple_no_type(C_indices),
+                                          UA_prefactor, A.name(), print_tuple_no_type(A_indices), UC_prefactor, C->name(),
+                                          print_tuple_no_type(C_indices))
+                            : fmt::format(R"(einsum: "{}"{} = {} "{}"{})", C->name(), print_tuple_no_type(C_indices), UA_prefactor,
+                                          A.name(), print_tuple_no_type(A_indices))};
+
+        const T C_prefactor = UC_prefactor;
+        const T A_prefactor = UA_prefactor;
+
+        ::einsums::detail::LoopNest<CRank, 2> target;
+        if constexpr (CRank != 0) {
+            for_sequence<CRank>([&](auto d) {
+                target.dims[d] = C->dim(d);
+                target.steps[d] = {C->stride(d), detail::loop_step<std::tuple_element_t<d, std::tuple<CIndices...>>>(A_indices, A)};
+            });
+        }
 
-    // Error check:  If there are any remaining indices then we cannot perform a sort
-    constexpr auto check = difference_t<std::tuple<AIndices...>, std::tuple<CIndices...>>();
-    static_assert(std::tuple_size_v<decltype(check)> == 0);
+        if constexpr (kind == detail::UnaryEinsumKind::Diagonal) {
+            detail::sort_strided_kernel(target, C_prefactor, C->data(), A_prefactor, A.data());
+        } else {
+            using LinkIndices = difference_t<c_unique_t<std::tuple<AIndices...>>, std::tuple<CIndices...>>;
+            constexpr size_t LinkRank = std::tuple_size_v<LinkIndices>;
 
-    auto target_position_in_A = detail::find_type_with_position(C_indices, A_indices);
+            ::einsums::detail::LoopNest<LinkRank, 1> link;
+            for_sequence<LinkRank>([&](auto d) {
+                using Index = std::tuple_element_t<d, LinkIndices>;
+                link.dims[d] = A.dim(detail::find_position<Index>(A_indices));
+                link.steps[d] = {detail::loop_step<Index>(A_indices, A)};
+            });
 
-    auto target_dims = get_dim_ranges<CRank>(*C);
-    auto a_dims = detail::get_dim_ranges_for(A, target_position_in_A);
+            detail::einsum_reduction_kernel(target, link, C_prefactor, C->data(), A_prefactor, A.data());
+        }
+    }
+}
 
-    // HPTT interface currently only works for full Tensors and not TensorViews
-#if defined(EINSUMS_USE_HPTT)
-    if constexpr (std::is_same_v<CType<T, CRank>, Tensor<T, CRank>> && std::is_same_v<AType<T, ARank>, Tensor<T, ARank>>) {
-        std::array<int, ARank> perms{};
-        std::array<int, ARank> size{};
+template <template <typename, size_t> typename AType, size_t ARank, template <typename, size_t> typename CType, size_t CRank,
+          typename... CIndices, typename... AIndices, typename T = double>
+auto einsum(const std::tuple<CIndices...> &C_indices, CType<T, CRank> *C, const std::tuple<AIndices...> &A_indices,
+            const AType<T, ARank> &A) -> std::enable_if_t<std::is_base_of_v<::einsums::detail::TensorBase<T, CRank>, CType<T, CRank>> &&
+                                                          std::is_base_of_v<::einsums::detail::TensorBase<T, ARank>, AType<T, ARank>>> {
+    einsum(0, C_indices, C, 1, A_indices, A);
+}
 
-        for (int i0 = 0; i0 < ARank; i0++) {
-            perms[i0] = get_from_tuple<unsigned long>(target_position_in_A, (2 * i0) + 1);
-            size[i0] = A.dim(i0);
-        }
+//
+// Multi-operand einsum
+//
 
-        auto plan = hptt::create_plan(perms.data(), ARank, A_prefactor, A.data(), size.data(), nullptr, C_prefactor, C->data(), nullptr,
-                                      hptt::ESTIMATE, omp_get_max_threads(), nullptr, true);
-        plan->execute();
-    } else
-#endif
-        if constexpr (std::is_same_v<decltype(A_indices), decltype(C_indices)>) {
-        if (C_prefactor != T{1.0})
-            linear_algebra::scale(C_prefactor, C);
-        linear_algebra::axpy(A_prefactor, A, C);
+/**
+ * Order in which a multi-operand einsum contracts its operands two at a time.
+ *
+ * Operands are numbered in the order they were given to einsum. Each step removes the two contracted operands from the
+ * list and appends their result to its end, following the numpy.einsum_path convention.
+ */
+struct EinsumPath {
+    std::vector<std::pair<size_t, size_t>> contractions;
+    /// Each step written as "labels,labels->labels".
+    std::vector<std::string> descriptions;
+    /// Floating-point operations performed by the whole path.
+    double flops{0};
+    /// Number of elements in the largest intermediate tensor.
+    size_t largest_intermediate{0};
+};
+
+/// Largest intermediate, in elements, a multi-operand einsum may allocate. Zero limits intermediates to the size of the
+/// largest input or output tensor. Paths that cannot meet the limit fall back to the one with the smallest intermediates.
+extern size_t einsum_path_memory_limit;
+
+namespace detail {
+
+/// Multi-operand einsums with at most this many operands are ordered by exhaustive search. Larger ones are first reduced
+/// to this many operands by greedy_einsum_path.
+constexpr size_t einsum_exhaustive_path_limit = 4;
+
+/// Most pairs of operands a greedy step chooses between. Every pair is instantiated, so this bounds the compile time.
+constexpr size_t einsum_greedy_candidates = 4;
+
+/// Searches every order of contracting operands after the steps in fixed for the one with the fewest flops, keeping
+/// intermediates under einsum_path_memory_limit. Operands and output are given as strings of index letters.
+auto optimize_einsum_path(const std::string &output, std::vector<std::string> operands, const std::map<char, size_t> &dims,
+                          const std::vector<std::pair<size_t, size_t>> &fixed) -> EinsumPath;
+
+/// Index into candidates of the contraction with the fewest flops for the given dims, the smaller intermediate breaking
+/// ties. The contraction is applied to operands.
+auto greedy_einsum_step(const std::string &output, std::vector<std::string> &operands, const std::map<char, size_t> &dims,
+                        const std::vector<std::pair<size_t, size_t>> &candidates) -> size_t;
+
+template <typename... Indices>
+auto index_letters(const std::tuple<Indices...> & /*indices*/) -> std::string {
+    return std::string{std::decay_t<Indices>::letter...};
+}
+
+template <typename... Tuples>
+auto concatenate_indices(const std::tuple<Tuples...> &) -> decltype(std::tuple_cat(std::declval<Tuples>()...));
+
+template <size_t P, size_t Q, typename Operands, size_t... I>
+auto remove_operands(std::index_sequence<I...>)
+    -> decltype(std::tuple_cat(std::conditional_t<I == P || I == Q, std::tuple<>, std::tuple<std::tuple_element_t<I, Operands>>>{}...));
+
+/**
+ * Result of contracting operands P and Q of a multi-operand einsum, where Operands is a tuple of the index tuples of every
+ * operand. The intermediate keeps the indices of P and then Q, without repeats, that are still needed by C or by one of
+ * the other operands.
+ */
+template <size_t P, size_t Q, typename CIndices, typename Operands>
+struct pairwise_contraction {
+    using left = std::tuple_element_t<P, Operands>;
+    using right = std::tuple_element_t<Q, Operands>;
+    using others = decltype(remove_operands<P, Q, Operands>(std::make_index_sequence<std::tuple_size_v<Operands>>()));
+    using needed = decltype(std::tuple_cat(std::declval<CIndices>(), concatenate_indices(std::declval<others>())));
+    using result = intersect_t<unique_t<decltype(std::tuple_cat(std::declval<left>(), std::declval<right>()))>, needed>;
+    using next = decltype(std::tuple_cat(std::declval<others>(), std::declval<std::tuple<result>>()));
+};
+
+/// Pairs of operands a greedy step chooses between, as first[n] and second[n] for n < count.
+struct GreedyCandidates {
+    std::array<size_t, einsum_greedy_candidates> first{};
+    std::array<size_t, einsum_greedy_candidates> second{};
+    size_t count{0};
+};
+
+/**
+ * The pairs of operands that share an index, or every pair if none do, whose intermediates have the lowest ranks. Pairs
+ * that share more indices come first among those of equal rank. Only the index ranks are known at compile time, so the
+ * dims decide between these pairs at run time.
+ */
+template <typename CIndices, typename Operands>
+constexpr auto greedy_candidates() -> GreedyCandidates {
+    bool any_shared{false};
+    for_sequence<std::tuple_size_v<Operands>>([&](auto p) {
+        constexpr size_t P = decltype(p)::value;
+        for_sequence<std::tuple_size_v<Operands>>([&](auto q) {
+            constexpr size_t Q = decltype(q)::value;
+            using shared = intersect_t<std::tuple_element_t<P, Operands>, std::tuple_element_t<Q, Operands>>;
+            if constexpr (P < Q && std::tuple_size_v<shared> != 0)
+                any_shared = true;
+        });
+    });
+
+    GreedyCandidates result;
+    std::array<size_t, einsum_greedy_candidates> ranks{}, shares{};
+    for_sequence<std::tuple_size_v<Operands>>([&](auto p) {
+        constexpr size_t P = decltype(p)::value;
+        for_sequence<std::tuple_size_v<Operands>>([&](auto q) {
+            constexpr size_t Q = decltype(q)::value;
+            if constexpr (P < Q) {
+                using contraction = pairwise_contraction<P, Q, CIndices, Operands>;
+                constexpr size_t rank = std::tuple_size_v<typename contraction::result>;
+                constexpr size_t shared = std::tuple_size_v<intersect_t<typename contraction::left, typename contraction::right>>;
+                if (any_shared && shared == 0)
+                    return;
+
+                // Insertion into the list sorted by rank, then by shared indices.
+                size_t n = result.count < einsum_greedy_candidates ? result.count++ : einsum_greedy_candidates;
+                for (; n > 0 && (rank < ranks[n - 1] || (rank == ranks[n - 1] && shared > shares[n - 1])); n--) {
+                    if (n < einsum_greedy_candidates) {
+                        result.first[n] = result.first[n - 1];
+                        result.second[n] = result.second[n - 1];
+                        ranks[n] = ranks[n - 1];
+                        shares[n] = shares[n - 1];
+                    }
+                }
+                if (n < einsum_greedy_candidates) {
+                    result.first[n] = P;
+                    result.second[n] = Q;
+                    ranks[n] = rank;
+                    shares[n] = shared;
+                }
+            }
+        });
+    });
+    return result;
+}
+
+/**
+ * Contracts operands greedily until einsum_exhaustive_path_limit remain, appending each contraction to path. Each step
+ * takes the cheapest of greedy_candidates for the actual dims. Operands holds the index letters of each operand.
+ */
+template <typename CIndices, typename Operands>
+void greedy_einsum_path(const std::string &output, std::vector<std::string> &operands, const std::map<char, size_t> &dims,
+                        std::vector<std::pair<size_t, size_t>> &path) {
+    if constexpr (std::tuple_size_v<Operands> > einsum_exhaustive_path_limit) {
+        constexpr GreedyCandidates candidates = greedy_candidates<CIndices, Operands>();
+        std::vector<std::pair<size_t, size_t>> pairs;
+        for (size_t n = 0; n < candidates.count; n++)
+            pairs.emplace_back(candidates.first[n], candidates.second[n]);
+
+        const size_t chosen = greedy_einsum_step(output, operands, dims, pairs);
+        path.push_back(pairs[chosen]);
+        for_sequence<einsum_greedy_candidates>([&](auto n) {
+            constexpr size_t N = decltype(n)::value;
+            constexpr GreedyCandidates next = greedy_candidates<CIndices, Operands>();
+            if constexpr (N < next.count) {
+                if (chosen == N)
+                    greedy_einsum_path<CIndices, typename pairwise_contraction<next.first[N], next.second[N], CIndices, Operands>::next>(
+                        output, operands, dims, path);
+            }
+        });
+    }
+}
+
+template <typename Index, typename Left, typename Right>
+auto operand_dim(const Left &left, const Right &right) -> size_t {
+    constexpr int position = find_position<Index>(decltype(left.first){});
+    if constexpr (position >= 0) {
+        return left.second->dim(position);
     } else {
-        auto view = std::apply(ranges::views::cartesian_product, target_dims);
-#if defined(__INTEL_LLVM_COMPILER) || defined(__INTEL_COMPILER)
-#pragma omp parallel for simd
-#else
-#pragma omp parallel for
-#endif
-        for (auto it = view.begin(); it < view.end(); it++) {
-            auto A_order = detail::construct_indices<AIndices...>(*it, target_position_in_A, *it, target_position_in_A);
+        return right.second->dim(find_position<Index>(decltype(right.first){}));
+    }
+}
 
-            T &target_value = std::apply(*C, *it);
-            T A_value = std::apply(A, A_order);
+template <typename T, typename... Indices, typename Left, typename Right>
+auto make_intermediate(const std::tuple<Indices...> & /*indices*/, const Left &left, const Right &right, const std::string &name) {
+    if constexpr (sizeof...(Indices) == 0) {
+        return std::make_shared<Tensor<T, 0>>(name);
+    } else {
+        return std::make_shared<Tensor<T, sizeof...(Indices)>>(name, operand_dim<Indices>(left, right)...);
+    }
+}
 
-            target_value = C_prefactor * target_value + A_prefactor * A_value;
-        }
+template <bool Keep, typename Operand>
+auto keep_operand(Operand &&operand) {
+    if constexpr (Keep) {
+        return std::make_tuple(std::forward<Operand>(operand));
+    } else {
+        return std::tuple<>{};
     }
-} // namespace einsums::TensorAlgebra
+}
 
-// Sort with default values, no smart pointers
-template <typename ObjectA, typename ObjectC, typename... CIndices, typename... AIndices>
-auto sort(const std::tuple<CIndices...> &C_indices, ObjectC *C, const std::tuple<AIndices...> &A_indices, const ObjectA &A)
-    -> std::enable_if_t<!is_smart_pointer_v<ObjectA> && !is_smart_pointer_v<ObjectC>> {
-    sort(0, C_indices, C, 1, A_indices, A);
+template <size_t P, size_t Q, typename... Operands, size_t... I>
+auto remove_operands(std::tuple<Operands...> &&operands, std::index_sequence<I...>) {
+    return std::tuple_cat(keep_operand<I != P && I != Q>(std::get<I>(std::move(operands)))...);
 }
 
-// Sort with default values, two smart pointers
-template <typename SmartPointerA, typename SmartPointerC, typename... CIndices, typename... AIndices>
-auto sort(const std::tuple<CIndices...> &C_indices, SmartPointerC *C, const std::tuple<AIndices...> &A_indices, const SmartPointerA &A)
-    -> std::enable_if_t<is_smart_pointer_v<SmartPointerA> && is_smart_pointer_v<SmartPointerC>> {
-    sort(0, C_indices, C->get(), 1, A_indices, *A);
+template <typename CType, typename... CIndices, typename T, typename... Operands>
+void einsum_execute_path(const EinsumPath &path, size_t step, const T C_prefactor, const std::tuple<CIndices...> &C_indices, CType *C,
+                         const T AB_prefactor, std::tuple<Operands...> &&operands);
+
+/// Contracts operands P and Q into a new intermediate, appends it to the operand list and continues along the path.
+template <size_t P, size_t Q, typename CType, typename... CIndices, typename T, typename... Operands>
+void einsum_contract_pair(const EinsumPath &path, size_t step, const T C_prefactor, const std::tuple<CIndices...> &C_indices, CType *C,
+                          const T AB_prefactor, std::tuple<Operands...> &&operands) {
+    using contraction = pairwise_contraction<P, Q, std::tuple<CIndices...>, std::tuple<typename Operands::first_type...>>;
+    using ResultIndices = typename contraction::result;
+
+    auto &left = std::get<P>(operands);
+    auto &right = std::get<Q>(operands);
+    auto intermediate = make_intermediate<T>(ResultIndices{}, left, right, fmt::format("einsum intermediate {}", step));
+    tensor_algebra::einsum(T{0}, ResultIndices{}, intermediate.get(), T{1}, left.first, *left.second, right.first, *right.second);
+
+    auto remaining = remove_operands<P, Q>(std::move(operands), std::make_index_sequence<sizeof...(Operands)>());
+    einsum_execute_path(path, step + 1, C_prefactor, C_indices, C, AB_prefactor,
+                        std::tuple_cat(std::move(remaining), std::make_tuple(std::make_pair(ResultIndices{}, std::move(intermediate)))));
 }
 
-// Sort with default values, one smart pointer (A)
-template <typename SmartPointerA, typename PointerC, typename... CIndices, typename... AIndices>
-auto sort(const std::tuple<CIndices...> &C_indices, PointerC *C, const std::tuple<AIndices...> &A_indices, const SmartPointerA &A)
-    -> std::enable_if_t<is_smart_pointer_v<SmartPointerA> && !is_smart_pointer_v<PointerC>> {
-    sort(0, C_indices, C, 1, A_indices, *A);
+/**
+ * Performs the contractions of path from the given step on. Each operand is a pair of its index tuple and a pointer to its
+ * tensor; intermediates are owned by shared pointers and released as soon as they have been contracted.
+ */
+template <typename CType, typename... CIndices, typename T, typename... Operands>
+void einsum_execute_path(const EinsumPath &path, size_t step, const T C_prefactor, const std::tuple<CIndices...> &C_indices, CType *C,
+                         const T AB_prefactor, std::tuple<Operands...> &&operands) {
+    using OperandIndices = std::tuple<typename Operands::first_type...>;
+
+    if constexpr (sizeof...(Operands) == 2) {
+        auto &[A_indices, A] = std::get<0>(operands);
+        auto &[B_indices, B] = std::get<1>(operands);
+        tensor_algebra::einsum(C_prefactor, C_indices, C, AB_prefactor, A_indices, *A, B_indices, *B);
+    } else if constexpr (sizeof...(Operands) > einsum_exhaustive_path_limit) {
+        // A greedy step, one of the candidates instantiated for these operands.
+        const auto &chosen = path.contractions[step];
+        for_sequence<einsum_greedy_candidates>([&](auto n) {
+            constexpr size_t N = decltype(n)::value;
+            constexpr GreedyCandidates candidates = greedy_candidates<std::tuple<CIndices...>, OperandIndices>();
+            if constexpr (N < candidates.count) {
+                if (chosen.first == candidates.first[N] && chosen.second == candidates.second[N])
+                    einsum_contract_pair<candidates.first[N], candidates.second[N]>(path, step, C_prefactor, C_indices, C, AB_prefactor,
+                                                                                    std::move(operands));
+            }
+        });
+    } else {
+        const auto &next = path.contractions[step];
+        for_sequence<sizeof...(Operands)>([&](auto p) {
+            constexpr size_t P = decltype(p)::value;
+            for_sequence<sizeof...(Operands)>([&](auto q) {
+                constexpr size_t Q = decltype(q)::value;
+                if constexpr (P < Q) {
+                    if (next.first == P && next.second == Q)
+                        einsum_contract_pair<P, Q>(path, step, C_prefactor, C_indices, C, AB_prefactor, std::move(operands));
+                }
+            });
+        });
+    }
 }
 
-// Sort with default values, one smart pointer (C)
-template <typename ObjectA, typename SmartPointerC, typename... CIndices, typename... AIndices>
-auto sort(const std::tuple<CIndices...> &C_indices, SmartPointerC *C, const std::tuple<AIndices...> &A_indices, const ObjectA &A)
-    -> std::enable_if_t<!is_smart_pointer_v<ObjectA> && is_smart_pointer_v<SmartPointerC>> {
-    sort(0, C_indices, C->get(), 1, A_indices, A);
+template <typename Operand>
+void record_dims(std::map<char, size_t> &dims, const Operand &operand) {
+    for_sequence<std::tuple_size_v<decltype(operand.first)>>([&](auto n) {
+        dims[std::decay_t<std::tuple_element_t<decltype(n)::value, decltype(operand.first)>>::letter] = operand.second->dim(n);
+    });
+}
+
+template <typename... Indices>
+auto as_tuple(const std::tuple<Indices...> &indices) -> std::tuple<Indices...> {
+    return indices;
+}
+
+/// Pairs up the (indices, tensor) arguments of a multi-operand einsum.
+template <typename... Args, size_t... I>
+auto make_operands(const std::tuple<const Args &...> &args, std::index_sequence<I...>) {
+    return std::make_tuple(std::make_pair(as_tuple(std::get<2 * I>(args)), &std::get<2 * I + 1>(args))...);
+}
+
+template <typename CType, typename... CIndices, typename... Operands>
+auto einsum_path(const std::tuple<CIndices...> &C_indices, const CType *C, const std::tuple<Operands...> &operands) -> EinsumPath {
+    std::map<char, size_t> dims;
+    std::vector<std::string> letters;
+    record_dims(dims, std::make_pair(as_tuple(C_indices), C));
+    std::apply(
+        [&](const auto &...operand) {
+            (record_dims(dims, operand), ...);
+            (letters.push_back(index_letters(operand.first)), ...);
+        },
+        operands);
+
+    std::vector<std::pair<size_t, size_t>> greedy;
+    std::vector<std::string> remaining{letters};
+    greedy_einsum_path<std::tuple<CIndices...>, std::tuple<typename Operands::first_type...>>(index_letters(C_indices), remaining, dims,
+                                                                                             greedy);
+    return optimize_einsum_path(index_letters(C_indices), letters, dims, greedy);
+}
+
+} // namespace detail
+
+/**
+ * Contraction path that einsum(C_indices, C, A_indices, A, B_indices, B, D_indices, D, ...) would follow for these
+ * operands. The returned path does not depend on the contents of the tensors.
+ */
+template <template <typename, size_t> typename CType, typename T, size_t CRank, typename... CIndices, typename... Rest>
+auto einsum_path(const std::tuple<CIndices...> &C_indices, const CType<T, CRank> *C, const Rest &...rest)
+    -> std::enable_if_t<(sizeof...(Rest) >= 4) && (sizeof...(Rest) % 2 == 0), EinsumPath> {
+    auto operands = detail::make_operands(std::forward_as_tuple(rest...), std::make_index_sequence<sizeof...(Rest) / 2>());
+    return detail::einsum_path(C_indices, C, operands);
+}
+
+/**
+ * Multi-operand einsum: C = C_prefactor * C + AB_prefactor * A * B * D * ...
+ *
+ * The operands are contracted two at a time through the two-operand einsum, in the order given by einsum_path. The
+ * intermediate tensors are allocated here and freed as soon as they have been used.
+ */
+template <template <typename, size_t> typename CType, typename T, size_t CRank, typename U, typename... CIndices, typename... Rest>
+auto einsum(const U UC_prefactor, const std::tuple<CIndices...> &C_indices, CType<T, CRank> *C, const U UAB_prefactor, const Rest &...rest)
+    -> std::enable_if_t<std::is_arithmetic_v<U> && (sizeof...(Rest) >= 6) && (sizeof...(Rest) % 2 == 0)> {
+    auto operands = detail::make_operands(std::forward_as_tuple(rest...), std::make_index_sequence<sizeof...(Rest) / 2>());
+    const EinsumPath path = detail::einsum_path(C_indices, C, operands);
+
+    std::string description = fmt::format("{}", fmt::join(path.descriptions, " "));
+    Section section{fmt::format("einsum path: {}", description)};
+
+    detail::einsum_execute_path(path, 0, static_cast<T>(UC_prefactor), C_indices, C, static_cast<T>(UAB_prefactor), std::move(operands));
+}
+
+template <template <typename, size_t> typename CType, typename T, size_t CRank, typename... CIndices, typename... Rest>
+auto einsum(const std::tuple<CIndices...> &C_indices, CType<T, CRank> *C, const Rest &...rest)
+    -> std::enable_if_t<(sizeof...(Rest) >= 6) && (sizeof...(Rest) % 2 == 0)> {
+    einsum(0, C_indices, C, 1, rest...);
 }
 
 //
@@ -1189,17 +3046,12 @@ template <template <typename, size_t> typename CType, size_t CRank, typename Una
 auto element_transform(CType<T, CRank> *C, UnaryOperator unary_opt)
     -> std::enable_if_t<std::is_base_of_v<::einsums::detail::TensorBase<T, CRank>, CType<T, CRank>>> {
     Section section(fmt::format("element transform: {}", C->name()));
-    auto target_dims = get_dim_ranges<CRank>(*C);
-    auto view = std::apply(ranges::views::cartesian_product, target_dims);
-#if defined(__INTEL_LLVM_COMPILER) || defined(__INTEL_COMPILER)
-#pragma omp parallel for simd
-#else
-#pragma omp parallel for
-#endif
-    for (auto it = view.begin(); it != view.end(); it++) {
-        T &target_value = std::apply(*C, *it);
+    auto nest = ::einsums::detail::make_loop_nest(*C);
+    T *data = C->data();
+    nest.parallel_for_each([&](const std::array<size_t, 1> &offset) {
+        T &target_value = data[offset[0]];
         target_value = unary_opt(target_value);
-    }
+    });
 }
 
 template <typename SmartPtr, typename UnaryOperator>
@@ -1207,27 +3059,33 @@ auto element_transform(SmartPtr *C, UnaryOperator unary_opt) -> std::enable_if_t
     element_transform(C->get(), unary_opt);
 }
 
+namespace detail {
+
+template <typename MultiOperator, typename T, typename... Pointers, size_t N, std::size_t... I>
+auto element_apply(MultiOperator &multi_opt, const T &value, const std::tuple<Pointers...> &data, const std::array<size_t, N> &offset,
+                   std::index_sequence<I...>) {
+    return multi_opt(value, std::get<I>(data)[offset[I + 1]]...);
+}
+
+} // namespace detail
+
 template <template <typename, size_t> typename CType, template <typename, size_t> typename... MultiTensors, size_t Rank,
           typename MultiOperator, typename T = double>
 auto element(MultiOperator multi_opt, CType<T, Rank> *C, MultiTensors<T, Rank> &...tensors) {
     Section section("element");
-    auto target_dims = get_dim_ranges<Rank>(*C);
-    auto view = std::apply(ranges::views::cartesian_product, target_dims);
 
     // Ensure the various tensors passed in are the same dimensionality
     if (((C->dims() != tensors.dims()) || ...)) {
         println_abort("element: at least one tensor does not have same dimensionality as destination");
     }
 
-#if defined(__INTEL_LLVM_COMPILER) || defined(__INTEL_COMPILER)
-#pragma omp parallel for simd
-#else
-#pragma omp parallel for
-#endif
-    for (auto it = view.begin(); it != view.end(); it++) {
-        T &target_value = std::apply(*C, *it);
-        target_value = multi_opt(target_value, std::apply(tensors, *it)...);
-    }
+    auto nest = ::einsums::detail::make_loop_nest(*C, tensors...);
+    T *target = C->data();
+    auto data = std::make_tuple(tensors.data()...);
+    nest.parallel_for_each([&](const std::array<size_t, 1 + sizeof...(MultiTensors)> &offset) {
+        T &target_value = target[offset[0]];
+        target_value = detail::element_apply(multi_opt, target_value, data, offset, std::index_sequence_for<MultiTensors<T, Rank>...>{});
+    });
 }
 
 template <int Remaining, typename Skip, typename Head, typename... Args>
@@ -1282,42 +3140,26 @@ auto unfold(const CType<T, CRank> &source) -> std::enable_if_t<std::is_same_v<Te
     }
 
     auto target = Tensor{fmt::format("mode-{} unfolding of {}", mode, source.name()), target_dims[0], target_dims[1]};
-    auto target_indices = std::make_tuple(std::get<mode>(index::list), index::Z);
-    auto source_indices = get_n<CRank>(index::list);
-
-    // Use similar logic found in einsums:
-    auto link = intersect_t<decltype(target_indices), decltype(source_indices)>();
-    auto target_only = difference_t<decltype(target_indices), decltype(link)>();
-    auto source_only = difference_t<decltype(source_indices), decltype(link)>();
-
-    auto source_position_in_source = detail::find_type_with_position(source_only, source_indices);
-    auto link_position_in_source = detail::find_type_with_position(link, source_indices);
-
-    auto link_dims = detail::get_dim_ranges_for(target, detail::find_type_with_position(link, target_indices));
-    auto source_dims = detail::get_dim_ranges_for(source, source_position_in_source);
-
-    auto link_view = std::apply(ranges::views::cartesian_product, link_dims);
-    auto source_view = std::apply(ranges::views::cartesian_product, source_dims);
-
-#pragma omp parallel for
-    for (auto link_it = link_view.begin(); link_it < link_view.end(); link_it++) {
-        size_t Z{0};
-        for (auto source_it = source_view.begin(); source_it < source_view.end(); source_it++) {
 
-            auto target_order = std::make_tuple(std::get<0>(*link_it), Z);
-
-            auto source_order =
-                detail::construct_indices(source_indices, *source_it, source_position_in_source, *link_it, link_position_in_source);
-
-            T &target_value = std::apply(target, target_order);
-            T source_value = std::apply(source, source_order);
-
-            target_value = source_value;
-
-            Z++;
-        }
+    // Loop over the mode index first and the remaining indices of source in order. Z, the column of target, is the
+    // ordinal of the remaining indices.
+    ::einsums::detail::LoopNest<CRank, 2> nest;
+    nest.dims[0] = source.dim(mode);
+    nest.steps[0] = {target.stride(0), source.stride(mode)};
+    size_t Z_step{1};
+    for (int i = CRank - 1, loop = CRank - 1; i >= 0; i--) {
+        if (i == mode)
+            continue;
+        nest.dims[loop] = source.dim(i);
+        nest.steps[loop] = {Z_step, source.stride(i)};
+        Z_step *= source.dim(i);
+        loop--;
     }
 
+    T *target_data = target.data();
+    const T *source_data = source.data();
+    nest.parallel_for_each([&](const std::array<size_t, 2> &offset) { target_data[offset[0]] = source_data[offset[1]]; });
+
     return target;
 }
 
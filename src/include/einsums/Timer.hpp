@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 namespace einsums::timer {
@@ -12,6 +13,10 @@ void report();
 void push(const std::string &name);
 void pop();
 
+/// Adds work timed elsewhere, such as on another thread, as a call of the child timer name of the current timer. With
+/// bytes, the report shows its throughput.
+void record(const std::string &name, double seconds, size_t bytes = 0);
+
 struct Timer {
     Timer(const std::string &name) { push(name); }
     ~Timer() { pop(); }
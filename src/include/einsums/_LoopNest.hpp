@@ -0,0 +1,161 @@
+#pragma once
+
+#include "einsums/OpenMP.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+namespace einsums::detail {
+
+/**
+ * Runtime description of a nest of loops shared by N operands.
+ *
+ * Each loop has a number of iterations and, for each operand, the step (in elements) the operand's offset takes when
+ * that loop index is incremented. An operand that does not depend on a loop has a step of zero; an operand indexed
+ * more than once by the same loop (a diagonal) has the sum of the corresponding strides.
+ *
+ * Loops are ordered from the outermost (slowest) to the innermost (fastest). Offsets are advanced like an odometer,
+ * so no element offset is ever recomputed from a full multi-index. The innermost loop is handed to the caller as a
+ * run of elements with constant steps so kernels can vectorize it.
+ */
+template <size_t Rank, size_t N>
+struct LoopNest {
+    using Offsets = std::array<size_t, N>;
+
+    std::array<size_t, Rank> dims{};
+    std::array<Offsets, Rank> steps{};
+
+    /// Total number of iterations of the loop nest. A rank-0 loop nest iterates exactly once.
+    [[nodiscard]] auto size() const -> size_t {
+        size_t result{1};
+        for (size_t d = 0; d < Rank; d++)
+            result *= dims[d];
+        return result;
+    }
+
+    /// Offsets of each operand at the given ordinal of the loop nest.
+    [[nodiscard]] auto offsets(size_t ordinal) const -> Offsets {
+        Offsets result{};
+        for (size_t d = Rank; d-- > 0;) {
+            size_t index = ordinal % dims[d];
+            ordinal /= dims[d];
+            for (size_t n = 0; n < N; n++)
+                result[n] += index * steps[d][n];
+        }
+        return result;
+    }
+
+    /**
+     * Calls f(offsets, count, inner_steps) for each run of the innermost loop that falls in the ordinals [begin, end).
+     * The elements of a run are found at offsets[n] + i * inner_steps[n] for i in [0, count).
+     */
+    template <typename Function>
+    void for_each_run(size_t begin, size_t end, Function &&f) const {
+        if (begin >= end)
+            return;
+
+        if constexpr (Rank == 0) {
+            f(Offsets{}, size_t{1}, Offsets{});
+        } else {
+            std::array<size_t, Rank> index{};
+            size_t ordinal = begin;
+            for (size_t d = Rank; d-- > 0;) {
+                index[d] = ordinal % dims[d];
+                ordinal /= dims[d];
+            }
+            Offsets offset = offsets(begin);
+
+            const Offsets &inner = steps[Rank - 1];
+            ordinal = begin;
+            while (ordinal < end) {
+                const size_t count = std::min(dims[Rank - 1] - index[Rank - 1], end - ordinal);
+                f(offset, count, inner);
+                ordinal += count;
+
+                // Advance the odometer to the start of the next run.
+                index[Rank - 1] += count;
+                for (size_t n = 0; n < N; n++)
+                    offset[n] += count * inner[n];
+                for (size_t d = Rank - 1; d > 0 && index[d] == dims[d]; d--) {
+                    index[d] = 0;
+                    index[d - 1]++;
+                    for (size_t n = 0; n < N; n++)
+                        offset[n] += steps[d - 1][n] - dims[d] * steps[d][n];
+                }
+            }
+        }
+    }
+
+    /// Calls f(offsets) for each element in the ordinals [begin, end).
+    template <typename Function>
+    void for_each(size_t begin, size_t end, Function &&f) const {
+        bool unit_stride = true;
+        if constexpr (Rank != 0) {
+            for (size_t n = 0; n < N; n++)
+                unit_stride = unit_stride && steps[Rank - 1][n] == 1;
+        }
+
+        for_each_run(begin, end, [&](const Offsets &offset, size_t count, const Offsets &inner) {
+            Offsets element;
+            if (unit_stride) {
+                for (size_t i = 0; i < count; i++) {
+                    for (size_t n = 0; n < N; n++)
+                        element[n] = offset[n] + i;
+                    f(element);
+                }
+            } else {
+                for (size_t i = 0; i < count; i++) {
+                    for (size_t n = 0; n < N; n++)
+                        element[n] = offset[n] + i * inner[n];
+                    f(element);
+                }
+            }
+        });
+    }
+
+    /// Splits the loop nest into contiguous ordinal ranges, one per OpenMP thread, and calls for_each_run on each.
+    template <typename Function>
+    void parallel_for_each_run(Function &&f) const {
+        const size_t total = size();
+#pragma omp parallel
+        {
+            const size_t threads = omp_get_num_threads();
+            const size_t thread = omp_get_thread_num();
+            const size_t chunk = (total + threads - 1) / threads;
+            const size_t begin = std::min(total, thread * chunk);
+            const size_t end = std::min(total, begin + chunk);
+            for_each_run(begin, end, f);
+        }
+    }
+
+    /// Splits the loop nest into contiguous ordinal ranges, one per OpenMP thread, and calls for_each on each.
+    template <typename Function>
+    void parallel_for_each(Function &&f) const {
+        const size_t total = size();
+#pragma omp parallel
+        {
+            const size_t threads = omp_get_num_threads();
+            const size_t thread = omp_get_thread_num();
+            const size_t chunk = (total + threads - 1) / threads;
+            const size_t begin = std::min(total, thread * chunk);
+            const size_t end = std::min(total, begin + chunk);
+            for_each(begin, end, f);
+        }
+    }
+};
+
+/// Loop nest over the dimensions of the first tensor, following the strides of every tensor in turn.
+template <template <typename, size_t> typename FirstType, typename T, size_t Rank, typename... Rest>
+auto make_loop_nest(const FirstType<T, Rank> &first, const Rest &...rest) -> LoopNest<Rank, 1 + sizeof...(Rest)> {
+    LoopNest<Rank, 1 + sizeof...(Rest)> nest;
+    if constexpr (Rank != 0) {
+        for (size_t d = 0; d < Rank; d++) {
+            nest.dims[d] = first.dim(d);
+            nest.steps[d] = {first.stride(d), rest.stride(d)...};
+        }
+    }
+    return nest;
+}
+
+} // namespace einsums::detail
@@ -0,0 +1,319 @@
+#pragma once
+
+#include "einsums/Print.hpp"
+#include "einsums/STL.hpp"
+#include "einsums/_Common.hpp"
+#include "einsums/_LoopNest.hpp"
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace einsums {
+
+/**
+ * Base of the lazy element-wise expressions built by applying + - * / and unary() to tensors, tensor views and
+ * scalars. Nothing is computed until an expression is assigned to (or used to construct) a Tensor or TensorView; the
+ * whole tree is then evaluated in a single parallel pass over the target.
+ *
+ * Operands are referenced, not copied, so an expression must not outlive the tensors it was built from. The target
+ * may appear in the expression only if every occurrence has the same layout as the target itself.
+ */
+template <typename Derived>
+struct TensorExpression {
+    [[nodiscard]] auto self() const -> const Derived & { return static_cast<const Derived &>(*this); }
+};
+
+namespace detail {
+
+template <typename X>
+struct IsTensorOperand : std::false_type {};
+template <typename T, size_t Rank>
+struct IsTensorOperand<Tensor<T, Rank>> : std::bool_constant<Rank != 0> {};
+template <typename T, size_t Rank>
+struct IsTensorOperand<TensorView<T, Rank>> : std::bool_constant<Rank != 0> {};
+
+template <typename X>
+inline constexpr bool is_expression_operand_v = IsTensorOperand<X>::value || std::is_base_of_v<TensorExpression<X>, X>;
+
+template <typename X>
+inline constexpr bool is_expression_scalar_v = std::is_arithmetic_v<X> || is_complex_v<X>;
+
+/// True if L and R may be combined by a binary operator: two expression operands, or one and a scalar.
+template <typename L, typename R>
+inline constexpr bool is_expression_pair_v = (is_expression_operand_v<L> && (is_expression_operand_v<R> || is_expression_scalar_v<R>)) ||
+                                             (is_expression_scalar_v<L> && is_expression_operand_v<R>);
+
+/*
+ * Every node provides
+ *   rank, operands      rank of the expression and number of tensors read by it
+ *   dims()              dimensions of the result (the dims of its first tensor)
+ *   steps<First>(nest)  writes the strides of its tensors into columns First... of the loop nest; false if a tensor's
+ *                       dims differ from those of the loop nest
+ *   eval<First, Unit>   the value at element i of a run; Unit is set when every inner step is one
+ */
+
+template <typename T, size_t Rank>
+struct TensorOperand : TensorExpression<TensorOperand<T, Rank>> {
+    using value_type = T;
+    static constexpr size_t rank = Rank;
+    static constexpr size_t operands = 1;
+
+    template <template <typename, size_t> typename TensorType>
+    explicit TensorOperand(const TensorType<T, Rank> &tensor) : data{tensor.data()}, _dims{tensor.dims()} {
+        for (size_t d = 0; d < Rank; d++)
+            _strides[d] = tensor.stride(d);
+    }
+
+    [[nodiscard]] auto dims() const -> Dim<Rank> { return _dims; }
+
+    template <size_t First, size_t N>
+    auto steps(LoopNest<Rank, N> &nest) const -> bool {
+        for (size_t d = 0; d < Rank; d++) {
+            if (_dims[d] != nest.dims[d])
+                return false;
+            nest.steps[d][First] = _strides[d];
+        }
+        return true;
+    }
+
+    template <size_t First, bool Unit, size_t N>
+    auto eval(const std::array<size_t, N> &offset, const std::array<size_t, N> &step, size_t i) const -> value_type {
+        if constexpr (Unit)
+            return data[offset[First] + i];
+        else
+            return data[offset[First] + i * step[First]];
+    }
+
+    const T *data;
+
+  private:
+    Dim<Rank> _dims;
+    std::array<size_t, Rank> _strides{};
+};
+
+template <typename T, size_t Rank>
+struct ScalarOperand : TensorExpression<ScalarOperand<T, Rank>> {
+    using value_type = T;
+    static constexpr size_t rank = Rank;
+    static constexpr size_t operands = 0;
+
+    explicit ScalarOperand(T value) : value{value} {}
+
+    template <size_t First, size_t N>
+    auto steps(LoopNest<Rank, N> &) const -> bool {
+        return true;
+    }
+
+    template <size_t First, bool Unit, size_t N>
+    auto eval(const std::array<size_t, N> &, const std::array<size_t, N> &, size_t) const -> value_type {
+        return value;
+    }
+
+    T value;
+};
+
+template <typename L, typename R, typename Op>
+struct BinaryExpression : TensorExpression<BinaryExpression<L, R, Op>> {
+    using value_type =
+        std::decay_t<decltype(std::declval<Op>()(std::declval<typename L::value_type>(), std::declval<typename R::value_type>()))>;
+    static constexpr size_t rank = L::rank;
+    static constexpr size_t operands = L::operands + R::operands;
+
+    static_assert(L::rank == R::rank, "tensor expression: operands must have the same rank");
+
+    BinaryExpression(L lhs, R rhs) : lhs{std::move(lhs)}, rhs{std::move(rhs)} {}
+
+    [[nodiscard]] auto dims() const -> Dim<rank> {
+        if constexpr (L::operands != 0)
+            return lhs.dims();
+        else
+            return rhs.dims();
+    }
+
+    template <size_t First, size_t N>
+    auto steps(LoopNest<rank, N> &nest) const -> bool {
+        return lhs.template steps<First>(nest) && rhs.template steps<First + L::operands>(nest);
+    }
+
+    template <size_t First, bool Unit, size_t N>
+    auto eval(const std::array<size_t, N> &offset, const std::array<size_t, N> &step, size_t i) const -> value_type {
+        return Op{}(lhs.template eval<First, Unit>(offset, step, i), rhs.template eval<First + L::operands, Unit>(offset, step, i));
+    }
+
+    L lhs;
+    R rhs;
+};
+
+template <typename E, typename Function>
+struct UnaryExpression : TensorExpression<UnaryExpression<E, Function>> {
+    using value_type = std::decay_t<std::invoke_result_t<const Function &, typename E::value_type>>;
+    static constexpr size_t rank = E::rank;
+    static constexpr size_t operands = E::operands;
+
+    UnaryExpression(Function function, E expression) : function{std::move(function)}, expression{std::move(expression)} {}
+
+    [[nodiscard]] auto dims() const -> Dim<rank> { return expression.dims(); }
+
+    template <size_t First, size_t N>
+    auto steps(LoopNest<rank, N> &nest) const -> bool {
+        return expression.template steps<First>(nest);
+    }
+
+    template <size_t First, bool Unit, size_t N>
+    auto eval(const std::array<size_t, N> &offset, const std::array<size_t, N> &step, size_t i) const -> value_type {
+        return function(expression.template eval<First, Unit>(offset, step, i));
+    }
+
+    Function function;
+    E expression;
+};
+
+template <typename Derived>
+auto as_expression(const TensorExpression<Derived> &expression) -> Derived {
+    return expression.self();
+}
+
+template <template <typename, size_t> typename TensorType, typename T, size_t Rank>
+auto as_expression(const TensorType<T, Rank> &tensor)
+    -> std::enable_if_t<IsTensorOperand<TensorType<T, Rank>>::value, TensorOperand<T, Rank>> {
+    return TensorOperand<T, Rank>{tensor};
+}
+
+template <typename Op, typename LHS, typename RHS>
+auto make_binary_expression(const LHS &lhs, const RHS &rhs) {
+    if constexpr (is_expression_scalar_v<LHS>) {
+        auto r = as_expression(rhs);
+        using Scalar = ScalarOperand<LHS, decltype(r)::rank>;
+        return BinaryExpression<Scalar, decltype(r), Op>{Scalar{lhs}, std::move(r)};
+    } else if constexpr (is_expression_scalar_v<RHS>) {
+        auto l = as_expression(lhs);
+        using Scalar = ScalarOperand<RHS, decltype(l)::rank>;
+        return BinaryExpression<decltype(l), Scalar, Op>{std::move(l), Scalar{rhs}};
+    } else {
+        auto l = as_expression(lhs);
+        auto r = as_expression(rhs);
+        return BinaryExpression<decltype(l), decltype(r), Op>{std::move(l), std::move(r)};
+    }
+}
+
+struct AssignElement {
+    template <typename T, typename U>
+    void operator()(T &target, const U &value) const {
+        target = value;
+    }
+};
+
+struct AddElement {
+    template <typename T, typename U>
+    void operator()(T &target, const U &value) const {
+        target += value;
+    }
+};
+
+struct SubtractElement {
+    template <typename T, typename U>
+    void operator()(T &target, const U &value) const {
+        target -= value;
+    }
+};
+
+template <size_t Rank, size_t N, typename T, typename E, typename Operation>
+void evaluate_loop_nest(const LoopNest<Rank, N> &nest, T *target, const E &expression, const Operation &operation) {
+    bool unit{true};
+    if constexpr (Rank != 0) {
+        for (size_t n = 0; n < N; n++)
+            unit = unit && nest.steps[Rank - 1][n] == 1;
+    }
+
+    nest.parallel_for_each_run([&](const std::array<size_t, N> &offset, size_t count, const std::array<size_t, N> &step) {
+        if (unit) {
+            T *run = target + offset[0];
+#pragma omp simd
+            for (size_t i = 0; i < count; i++)
+                operation(run[i], expression.template eval<1, true>(offset, step, i));
+        } else {
+            for (size_t i = 0; i < count; i++)
+                operation(target[offset[0] + i * step[0]], expression.template eval<1, false>(offset, step, i));
+        }
+    });
+}
+
+/**
+ * Applies operation(target element, expression value) to every element of target in one pass. When the target and
+ * every tensor in the expression are packed row-major the nest is collapsed to a single loop, so the whole tensor is
+ * one unit-stride run per thread.
+ */
+template <typename TargetType, typename E, typename Operation>
+void evaluate_expression(TargetType &target, const E &expression, const Operation &operation) {
+    constexpr size_t Rank = E::rank;
+    constexpr size_t N = 1 + E::operands;
+
+    LoopNest<Rank, N> nest;
+    for (size_t d = 0; d < Rank; d++) {
+        nest.dims[d] = target.dim(d);
+        nest.steps[d][0] = target.stride(d);
+    }
+    if (!expression.template steps<1>(nest))
+        println_abort("tensor expression: operands do not have the dimensions of the target {}", target.name());
+
+    bool packed{true};
+    for (size_t n = 0; n < N && packed; n++) {
+        size_t expected{1};
+        for (size_t d = Rank; d-- > 0;) {
+            if (nest.steps[d][n] != expected && nest.dims[d] != 1) {
+                packed = false;
+                break;
+            }
+            expected *= nest.dims[d];
+        }
+    }
+
+    if (packed) {
+        LoopNest<1, N> flat;
+        flat.dims[0] = nest.size();
+        flat.steps[0].fill(1);
+        evaluate_loop_nest(flat, target.data(), expression, operation);
+    } else {
+        evaluate_loop_nest(nest, target.data(), expression, operation);
+    }
+}
+
+} // namespace detail
+
+template <typename LHS, typename RHS, typename = std::enable_if_t<detail::is_expression_pair_v<LHS, RHS>>>
+auto operator+(const LHS &lhs, const RHS &rhs) {
+    return detail::make_binary_expression<std::plus<>>(lhs, rhs);
+}
+
+template <typename LHS, typename RHS, typename = std::enable_if_t<detail::is_expression_pair_v<LHS, RHS>>>
+auto operator-(const LHS &lhs, const RHS &rhs) {
+    return detail::make_binary_expression<std::minus<>>(lhs, rhs);
+}
+
+template <typename LHS, typename RHS, typename = std::enable_if_t<detail::is_expression_pair_v<LHS, RHS>>>
+auto operator*(const LHS &lhs, const RHS &rhs) {
+    return detail::make_binary_expression<std::multiplies<>>(lhs, rhs);
+}
+
+template <typename LHS, typename RHS, typename = std::enable_if_t<detail::is_expression_pair_v<LHS, RHS>>>
+auto operator/(const LHS &lhs, const RHS &rhs) {
+    return detail::make_binary_expression<std::divides<>>(lhs, rhs);
+}
+
+template <typename E, typename = std::enable_if_t<detail::is_expression_operand_v<E>>>
+auto operator-(const E &expression) {
+    auto e = detail::as_expression(expression);
+    return detail::UnaryExpression<decltype(e), std::negate<>>{std::negate<>{}, std::move(e)};
+}
+
+/// Lazily applies function to each element of expression, e.g. unary([](double x) { return std::exp(x); }, A - B).
+template <typename Function, typename E, typename = std::enable_if_t<detail::is_expression_operand_v<E>>>
+auto unary(Function function, const E &expression) {
+    auto e = detail::as_expression(expression);
+    return detail::UnaryExpression<decltype(e), Function>{std::move(function), std::move(e)};
+}
+
+} // namespace einsums
@@ -1,4 +1,5 @@
 #define CATCH_CONFIG_RUNNER
+#include "einsums/AsyncIO.hpp"
 #include "einsums/Blas.hpp"
 #include "einsums/OpenMP.h"
 #include "einsums/Print.hpp"
@@ -22,6 +23,7 @@ auto main(int argc, char *argv[]) -> int {
 
     int result = Catch::Session().run(argc, argv);
 
+    einsums::io::finalize();
     // einsums::timer::report();
     einsums::blas::finalize();
     einsums::timer::finalize();
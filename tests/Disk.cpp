@@ -1,7 +1,9 @@
+#include "einsums/AsyncIO.hpp"
 #include "einsums/LinearAlgebra.hpp"
 #include "einsums/Print.hpp"
 #include "einsums/STL.hpp"
 #include "einsums/Tensor.hpp"
+#include "einsums/TensorAlgebra.hpp"
 #include "einsums/Timer.hpp"
 #include "einsums/Utilities.hpp"
 #include "range/v3/view/cartesian_product.hpp"
@@ -10,6 +12,7 @@
 #include <catch2/catch.hpp>
 #include <filesystem>
 #include <stdexcept>
+#include <string>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -197,3 +200,272 @@ TEST_CASE("DiskView 7x7x7x7", "[disktensor]") {
         }
     }
 }
+
+TEST_CASE("out of core einsum", "[disktensor]") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    // Small enough that every operand on disk is cut into several tiles.
+    const size_t limit = einsum_disk_memory_limit;
+    einsum_disk_memory_limit = 3000;
+
+    SECTION("gemm with every tensor on disk") {
+        Tensor A = create_random_tensor("A", 20, 17);
+        Tensor B = create_random_tensor("B", 17, 13);
+        Tensor C = create_random_tensor("C", 20, 13);
+        DiskTensor A_disk(state::data, "/ooc_A", 20, 17);
+        DiskTensor B_disk(state::data, "/ooc_B", 17, 13);
+        DiskTensor C_disk(state::data, "/ooc_C", 20, 13);
+        A_disk(All, All) = A;
+        B_disk(All, All) = B;
+        C_disk(All, All) = C;
+
+        einsum(0.5, Indices{i, j}, &C_disk, 2.0, Indices{i, k}, A_disk, Indices{k, j}, B_disk);
+        einsum(0.5, Indices{i, j}, &C, 2.0, Indices{i, k}, A, Indices{k, j}, B);
+
+        auto result = C_disk(All, All);
+        for (size_t x = 0; x < 20; x++) {
+            for (size_t y = 0; y < 13; y++)
+                REQUIRE_THAT(result(x, y), Catch::Matchers::WithinAbs(C(x, y), 1.0e-12));
+        }
+    }
+
+    SECTION("ladder term with the integrals on disk") {
+        const size_t o = 3, v = 6;
+        Tensor T2 = create_random_tensor("T2", o, o, v, v);
+        Tensor g = create_random_tensor("g", v, v, v, v);
+        DiskTensor g_disk(state::data, "/ooc_g", v, v, v, v);
+        g_disk(All, All, All, All) = g;
+
+        Tensor<double, 4> R{"R", o, o, v, v}, R_core{"R core", o, o, v, v};
+        einsum(Indices{i, j, a, b}, &R, Indices{i, j, c, d}, T2, Indices{c, d, a, b}, g_disk);
+        einsum(Indices{i, j, a, b}, &R_core, Indices{i, j, c, d}, T2, Indices{c, d, a, b}, g);
+
+        // The same term written to disk.
+        DiskTensor R_disk(state::data, "/ooc_R", o, o, v, v);
+        einsum(Indices{i, j, a, b}, &R_disk, Indices{i, j, c, d}, T2, Indices{c, d, a, b}, g);
+        auto R_read = R_disk(All, All, All, All);
+
+        for (size_t w = 0; w < o; w++) {
+            for (size_t x = 0; x < o; x++) {
+                for (size_t y = 0; y < v; y++) {
+                    for (size_t z = 0; z < v; z++) {
+                        REQUIRE_THAT(R(w, x, y, z), Catch::Matchers::WithinAbs(R_core(w, x, y, z), 1.0e-12));
+                        REQUIRE_THAT(R_read(w, x, y, z), Catch::Matchers::WithinAbs(R_core(w, x, y, z), 1.0e-12));
+                    }
+                }
+            }
+        }
+    }
+
+    einsum_disk_memory_limit = limit;
+}
+
+TEST_CASE("async DiskView", "[disktensor]") {
+    using namespace einsums;
+
+    Tensor data = create_random_tensor("data", 8, 5, 6);
+    DiskTensor g(state::data, "/async_g", 8, 5, 6);
+    g(All, All, All) = data;
+
+    SECTION("prefetch and write behind") {
+        const io::Statistics before = io::statistics();
+
+        for_each_slab(
+            8, [&](size_t n) { return g.async(n, All, All); },
+            [&](size_t n, Tensor<double, 2> &slab) {
+                for (size_t i = 0; i < 5; i++) {
+                    for (size_t j = 0; j < 6; j++) {
+                        REQUIRE(slab(i, j) == data(n, i, j));
+                        slab(i, j) *= 2.0;
+                    }
+                }
+            },
+            3);
+        io::flush();
+
+        const io::Statistics after = io::statistics();
+        REQUIRE(after.reads - before.reads == 8);
+        REQUIRE(after.writes - before.writes == 8);
+        REQUIRE(after.bytes_read - before.bytes_read == 8 * 5 * 6 * sizeof(double));
+
+        auto result = g(All, All, All);
+        for (size_t n = 0; n < 8; n++) {
+            for (size_t i = 0; i < 5; i++) {
+                for (size_t j = 0; j < 6; j++)
+                    REQUIRE(result(n, i, j) == 2.0 * data(n, i, j));
+            }
+        }
+        result.set_read_only(true);
+    }
+
+    SECTION("put and read only views") {
+        {
+            auto view = g.async(2, All, All);
+            view(1, 3) = 42.0;
+            view.put().wait();
+            view.set_read_only(true);
+        }
+        REQUIRE(g.async(2, All, All)(1, 3) == 42.0);
+        io::flush();
+
+        const io::Statistics before = io::statistics();
+        {
+            const auto &readable = g;
+            auto view = readable.async(4, All, All);
+            REQUIRE(view.get()(0, 0) == data(4, 0, 0));
+            REQUIRE_THROWS(view.put());
+        }
+        io::flush();
+        REQUIRE(io::statistics().writes == before.writes);
+    }
+
+    SECTION("write behind outlives the DiskTensor") {
+        for (int n = 0; n < 50; n++) {
+            const std::string name = "/async_gone" + std::to_string(n);
+            {
+                DiskTensor<double, 2> gone(state::data, name, 4, 5);
+                auto view = gone.async(Access::WriteDiscard, All, All);
+                view.get().set_all(n);
+            }
+            io::flush();
+
+            DiskTensor<double, 2> reopened(state::data, name, 4, 5);
+            auto result = reopened(All, All);
+            REQUIRE(result(3, 4) == n);
+            result.set_read_only(true);
+        }
+    }
+
+    SECTION("flush rethrows failed writes") {
+        auto fail = [] { throw std::runtime_error("failed write"); };
+        io::detail::submit(io::detail::Operation::Write, 0, fail);
+        REQUIRE_THROWS_AS(io::flush(), std::runtime_error);
+        REQUIRE_NOTHROW(io::flush());
+
+        const auto written = io::detail::submit(io::detail::Operation::Write, 0, fail);
+        REQUIRE_THROWS_AS(io::detail::wait(written), std::runtime_error);
+        REQUIRE_NOTHROW(io::flush());
+    }
+}
+
+TEST_CASE("DiskView access modes", "[disktensor]") {
+    using namespace einsums;
+
+    Tensor first = create_random_tensor("first", 6, 4);
+    Tensor second = create_random_tensor("second", 6, 4);
+    DiskTensor g(state::data, "/access_g", 6, 4);
+    g(Access::WriteDiscard, All, All) = first;
+
+    SECTION("untouched views are not written back") {
+        {
+            auto stale = g(All, All);
+            REQUIRE(std::as_const(stale)(2, 3) == first(2, 3));
+            REQUIRE_FALSE(stale.dirty());
+
+            g(All, All) = second;
+        }
+        auto result = g(Access::Read, All, All);
+        for (size_t i = 0; i < 6; i++) {
+            for (size_t j = 0; j < 4; j++)
+                REQUIRE(std::as_const(result)(i, j) == second(i, j));
+        }
+        REQUIRE_THROWS(result = first);
+    }
+
+    SECTION("changed views are written back") {
+        {
+            auto view = g(1, All);
+            view(2) = 42.0;
+            REQUIRE(view.dirty());
+        }
+        REQUIRE(std::as_const(g)(1, All)(2) == 42.0);
+    }
+
+    SECTION("async") {
+        io::flush();
+        io::Statistics before = io::statistics();
+        {
+            auto view = g.async(Access::WriteDiscard, 3, All);
+            view(0) = 7.0;
+            view(1) = 8.0;
+            view(2) = 9.0;
+            view(3) = 10.0;
+        }
+        {
+            auto view = g.async(Access::ReadWrite, 4, All);
+            REQUIRE(std::as_const(view).get()(1) == first(4, 1));
+        }
+        io::flush();
+        io::Statistics after = io::statistics();
+        REQUIRE(after.reads - before.reads == 1);
+        REQUIRE(after.writes - before.writes == 1);
+
+        auto view = g.async(Access::Read, 3, All);
+        REQUIRE(std::as_const(view)(3) == 10.0);
+        view.get();
+        REQUIRE_THROWS(view.put());
+    }
+}
+
+TEST_CASE("storage policy", "[disktensor]") {
+    using namespace einsums;
+
+    auto chunk_of = [](DiskTensor<double, 3> &A) {
+        hid_t dcpl = H5Dget_create_plist(A.disk());
+        std::array<hsize_t, 3> chunk{};
+        H5Pget_chunk(dcpl, 3, chunk.data());
+        const int filters = H5Pget_nfilters(dcpl);
+        H5Pclose(dcpl);
+        return std::make_tuple(chunk, filters);
+    };
+
+    SECTION("default") {
+        DiskTensor<double, 3> A(state::data, "/storage-default", 100, 10, 20);
+        auto [chunk, filters] = chunk_of(A);
+        REQUIRE(chunk == std::array<hsize_t, 3>{64, 10, 20});
+        REQUIRE(filters == 1);
+    }
+
+    SECTION("slabs along index 0") {
+        StoragePolicy policy;
+        policy.compression = Compression::None;
+        policy.slab_indices = {0};
+        policy.cache_bytes = size_t{8} << 20;
+        DiskTensor<double, 3> A(state::data, "/storage-slabs", policy, 4, 50, 60);
+        auto [chunk, filters] = chunk_of(A);
+        REQUIRE(chunk == std::array<hsize_t, 3>{1, 50, 60});
+        REQUIRE(filters == 0);
+
+        hid_t dapl = H5Dget_access_plist(A.disk());
+        size_t slots{0}, bytes{0};
+        double w0{0};
+        H5Pget_chunk_cache(dapl, &slots, &bytes, &w0);
+        H5Pclose(dapl);
+        REQUIRE(bytes == policy.cache_bytes);
+
+        Tensor Ad = create_random_tensor("A", 4, 50, 60);
+        A(All, All, All) = Ad;
+        auto slab = A(2, All, All);
+        for (size_t j = 0; j < 50; j++)
+            for (size_t k = 0; k < 60; k++)
+                REQUIRE(slab(j, k) == Ad(2, j, k));
+    }
+
+    SECTION("chunk size limit") {
+        StoragePolicy policy;
+        policy.slab_indices = {0};
+        policy.max_chunk_bytes = 50 * 30 * sizeof(double);
+        REQUIRE(einsums::detail::chunk_dims(policy, {4, 50, 60}, sizeof(double)) == std::vector<hsize_t>{1, 50, 30});
+    }
+
+    SECTION("plugin fallback") {
+        StoragePolicy policy;
+        policy.compression = Compression::LZ4;
+        policy.level = 1;
+        DiskTensor<double, 3> A(state::data, "/storage-lz4", policy, 8, 8, 8);
+        auto [chunk, filters] = chunk_of(A);
+        REQUIRE(filters == (compression_available(Compression::LZ4) ? 1 : 2));
+    }
+}
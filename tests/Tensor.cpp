@@ -7,6 +7,7 @@
 
 #include <H5Fpublic.h>
 #include <catch2/catch.hpp>
+#include <cstdio>
 #include <type_traits>
 
 TEST_CASE("Tensor creation", "[tensor]") {
@@ -298,6 +299,60 @@ TEST_CASE("Tensor 2D - HDF5 wrapper") {
             REQUIRE(B(i, j) == B(i, j));
 }
 
+TEST_CASE("TensorView - HDF5 write") {
+    using namespace einsums;
+
+    // Removes the file when the test ends, after fd has closed it.
+    struct RemoveFile {
+        ~RemoveFile() { std::remove("tensorview-write.h5"); }
+    } remove_file;
+
+    auto C = create_random_tensor("C", 4, 6);
+    h5::fd_t fd = h5::create("tensorview-write.h5", H5F_ACC_TRUNC);
+
+    auto check = [&](const TensorView<double, 2> &view, const std::string &name) {
+        auto B = read<2, double>(fd, name);
+        REQUIRE((B.dim(0) == view.dim(0) && B.dim(1) == view.dim(1)));
+        for (size_t i = 0; i < view.dim(0); i++)
+            for (size_t j = 0; j < view.dim(1); j++)
+                REQUIRE(B(i, j) == view(i, j));
+    };
+
+    SECTION("contiguous rows") {
+        TensorView view = C(Range{1, 3}, Range{2, 6});
+        view.set_name("rows");
+        write(fd, view);
+        check(view, "rows");
+    }
+
+    SECTION("strided last index") {
+        TensorView view(C, Dim<2>{4, 3}, Offset<2>{0, 1}, Stride<2>{6, 2});
+        view.set_name("strided");
+        write(fd, view);
+        check(view, "strided");
+    }
+
+    SECTION("strides that do not nest") {
+        TensorView view(C, Dim<2>{3, 2}, Offset<2>{0, 0}, Stride<2>{5, 3});
+        view.set_name("packed");
+        write(fd, view);
+        check(view, "packed");
+    }
+
+    SECTION("offset into an existing dataset") {
+        auto D = create_random_tensor("D", 5, 7);
+        write(fd, D);
+        TensorView view = C(Range{0, 2}, Range{0, 3});
+        view.set_name("D");
+        write(fd, view, h5::offset{2, 3});
+
+        auto B = read<2, double>(fd, "D");
+        for (size_t i = 0; i < 5; i++)
+            for (size_t j = 0; j < 7; j++)
+                REQUIRE(B(i, j) == (i >= 2 && i < 4 && j >= 3 && j < 6 ? C(i - 2, j - 3) : D(i, j)));
+    }
+}
+
 TEST_CASE("reshape") {
     SECTION("1") {
         auto C = einsums::create_incremented_tensor("C", 10, 10, 10);
@@ -349,4 +404,49 @@ TEST_CASE("types") {
     SECTION("double->complex<float>") {
         types_test<std::complex<float>, double>();
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Tensor expressions", "[tensor]") {
+    using namespace einsums;
+
+    auto A = create_random_tensor("A", 7, 9, 11);
+    auto B = create_random_tensor("B", 7, 9, 11);
+    auto C = create_random_tensor("C", 7, 9, 11);
+
+    SECTION("linear combination") {
+        Tensor<double, 3> R = 2.0 * A + B * 0.5 - C;
+
+        for (size_t i = 0; i < 7; i++)
+            for (size_t j = 0; j < 9; j++)
+                for (size_t k = 0; k < 11; k++)
+                    REQUIRE_THAT(R(i, j, k), Catch::Matchers::WithinAbs(2.0 * A(i, j, k) + 0.5 * B(i, j, k) - C(i, j, k), 1e-12));
+
+        R -= A * B / (C + 2.0);
+        for (size_t i = 0; i < 7; i++)
+            for (size_t j = 0; j < 9; j++)
+                for (size_t k = 0; k < 11; k++)
+                    REQUIRE_THAT(R(i, j, k), Catch::Matchers::WithinAbs(2.0 * A(i, j, k) + 0.5 * B(i, j, k) - C(i, j, k) -
+                                                                            A(i, j, k) * B(i, j, k) / (C(i, j, k) + 2.0),
+                                                                        1e-12));
+    }
+
+    SECTION("views and unary functions") {
+        auto R = create_random_tensor("R", 7, 9, 11);
+        auto R0 = R;
+
+        TensorView<double, 2> Rv{R, Dim<2>{3, 5}, Offset<3>{2, 1, 4}, Stride<2>{11, 1}};
+        TensorView<double, 2> Av{A, Dim<2>{3, 5}, Offset<3>{1, 3, 0}, Stride<2>{11, 1}};
+        TensorView<double, 2> Bv{B, Dim<2>{3, 5}, Offset<3>{4, 2, 6}, Stride<2>{11, 1}};
+
+        Rv += unary([](double x) { return std::exp(x); }, -Av) * Bv;
+
+        for (size_t i = 0; i < 7; i++)
+            for (size_t j = 0; j < 9; j++)
+                for (size_t k = 0; k < 11; k++) {
+                    double expected = R0(i, j, k);
+                    if (i == 2 && j >= 1 && j < 4 && k >= 4 && k < 9)
+                        expected += std::exp(-A(1, j + 2, k - 4)) * B(4, j + 1, k + 2);
+                    REQUIRE_THAT(R(i, j, k), Catch::Matchers::WithinAbs(expected, 1e-12));
+                }
+    }
+}
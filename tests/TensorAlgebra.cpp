@@ -1,14 +1,21 @@
 #include "einsums/TensorAlgebra.hpp"
 
+#include "einsums/BlockTensor.hpp"
 #include "einsums/LinearAlgebra.hpp"
 #include "einsums/STL.hpp"
+#include "einsums/SparseTensor.hpp"
 #include "einsums/State.hpp"
+#include "einsums/SymmetricTensor.hpp"
+#include "einsums/Telemetry.hpp"
 #include "einsums/Tensor.hpp"
 #include "einsums/Utilities.hpp"
 
 #include <H5Fpublic.h>
 #include <catch2/catch.hpp>
 #include <complex>
+#include <fstream>
+#include <iterator>
+#include <limits>
 #include <type_traits>
 
 TEST_CASE("Identity Tensor", "[tensor]") {
@@ -814,6 +821,40 @@ TEST_CASE("sort2") {
             }
         }
     }
+
+    SECTION("Rank 3 - TensorView blocks") {
+        Tensor A = create_random_tensor("A", 10, 12, 14);
+        Tensor C{"C", 14, 12, 10};
+        C.zero();
+
+        TensorView A_block = A(Range{1, 9}, Range{2, 12}, Range{3, 14});
+        TensorView C_block = C(Range{2, 13}, Range{1, 11}, Range{1, 9});
+
+        sort(Indices{k, j, i}, &C_block, Indices{i, j, k}, A_block);
+        for (size_t i = 0; i < A_block.dim(0); i++) {
+            for (size_t j = 0; j < A_block.dim(1); j++) {
+                for (size_t k = 0; k < A_block.dim(2); k++) {
+                    REQUIRE(C_block(k, j, i) == A_block(i, j, k));
+                }
+            }
+        }
+        REQUIRE(C(0, 0, 0) == 0.0);
+        REQUIRE(C(13, 11, 9) == 0.0);
+    }
+
+    SECTION("Rank 2 - strided TensorView") {
+        Tensor A = create_random_tensor("A", 40, 40, 3);
+        Tensor C{"C", 40, 40};
+
+        TensorView A_slice = A(All, All, 1);
+
+        sort(Indices{j, i}, &C, Indices{i, j}, A_slice);
+        for (size_t i = 0; i < A_slice.dim(0); i++) {
+            for (size_t j = 0; j < A_slice.dim(1); j++) {
+                REQUIRE(C(j, i) == A(i, j, 1));
+            }
+        }
+    }
 }
 
 TEST_CASE("einsum2") {
@@ -1703,6 +1744,1122 @@ TEST_CASE("Transpose C", "[einsum]") {
     }
 }
 
+TEST_CASE("ttgt", "[einsum]") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    size_t _m = 6, _n = 7, _e = 5, _f = 4, _b = 3, _j = 8;
+
+    SECTION("m,b,e,j <- j,n,f,b * m,n,e,f") {
+        Tensor A = create_random_tensor("A", _j, _n, _f, _b);
+        Tensor B = create_random_tensor("B", _m, _n, _e, _f);
+        Tensor C{"C", _m, _b, _e, _j};
+        Tensor C0{"C0", _m, _b, _e, _j};
+        C.zero();
+        C0.zero();
+
+        REQUIRE_NOTHROW(einsum(Indices{m, b, e, j}, &C, Indices{j, n, f, b}, A, Indices{m, n, e, f}, B));
+
+        for (size_t m0 = 0; m0 < _m; m0++) {
+            for (size_t b0 = 0; b0 < _b; b0++) {
+                for (size_t e0 = 0; e0 < _e; e0++) {
+                    for (size_t j0 = 0; j0 < _j; j0++) {
+                        for (size_t n0 = 0; n0 < _n; n0++) {
+                            for (size_t f0 = 0; f0 < _f; f0++) {
+                                C0(m0, b0, e0, j0) += A(j0, n0, f0, b0) * B(m0, n0, e0, f0);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        for (size_t m0 = 0; m0 < _m; m0++) {
+            for (size_t b0 = 0; b0 < _b; b0++) {
+                for (size_t e0 = 0; e0 < _e; e0++) {
+                    for (size_t j0 = 0; j0 < _j; j0++) {
+                        REQUIRE_THAT(C(m0, b0, e0, j0), Catch::Matchers::WithinAbs(C0(m0, b0, e0, j0), 0.001));
+                    }
+                }
+            }
+        }
+    }
+
+    SECTION("b,j,m,e <- 0.5 * j,n,f,b * m,e,n,f + 2.0 * b,j,m,e") {
+        // C is already laid out as (CA, CB) and B as (CB, links); only A is permuted.
+        Tensor A = create_random_tensor("A", _j, _n, _f, _b);
+        Tensor B = create_random_tensor("B", _m, _e, _n, _f);
+        Tensor C = create_random_tensor("C", _b, _j, _m, _e);
+        Tensor C0{"C0", _b, _j, _m, _e};
+        C0 = C;
+
+        REQUIRE_NOTHROW(einsum(2.0, Indices{b, j, m, e}, &C, 0.5, Indices{j, n, f, b}, A, Indices{m, e, n, f}, B));
+
+        for (size_t b0 = 0; b0 < _b; b0++) {
+            for (size_t j0 = 0; j0 < _j; j0++) {
+                for (size_t m0 = 0; m0 < _m; m0++) {
+                    for (size_t e0 = 0; e0 < _e; e0++) {
+                        double sum{0.0};
+                        for (size_t n0 = 0; n0 < _n; n0++) {
+                            for (size_t f0 = 0; f0 < _f; f0++) {
+                                sum += A(j0, n0, f0, b0) * B(m0, e0, n0, f0);
+                            }
+                        }
+                        C0(b0, j0, m0, e0) = 2.0 * C0(b0, j0, m0, e0) + 0.5 * sum;
+                    }
+                }
+            }
+        }
+
+        for (size_t b0 = 0; b0 < _b; b0++) {
+            for (size_t j0 = 0; j0 < _j; j0++) {
+                for (size_t m0 = 0; m0 < _m; m0++) {
+                    for (size_t e0 = 0; e0 < _e; e0++) {
+                        REQUIRE_THAT(C(b0, j0, m0, e0), Catch::Matchers::WithinAbs(C0(b0, j0, m0, e0), 0.001));
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("tiled generic", "[einsum]") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    // The repeated k in A rules out the BLAS based algorithms and the link space is large enough to be blocked.
+    size_t _i = 4, _j = 8, _k = 64, _l = 64;
+
+    SECTION("i,j <- i,k,l,k * k,l,j") {
+        Tensor A = create_random_tensor("A", _i, _k, _l, _k);
+        Tensor B = create_random_tensor("B", _k, _l, _j);
+        Tensor C{"C", _i, _j};
+        Tensor C0{"C0", _i, _j};
+        C.zero();
+        C0.zero();
+
+        REQUIRE_NOTHROW(einsum(Indices{i, j}, &C, Indices{i, k, l, k}, A, Indices{k, l, j}, B));
+
+        for (size_t i0 = 0; i0 < _i; i0++) {
+            for (size_t j0 = 0; j0 < _j; j0++) {
+                for (size_t k0 = 0; k0 < _k; k0++) {
+                    for (size_t l0 = 0; l0 < _l; l0++) {
+                        C0(i0, j0) += A(i0, k0, l0, k0) * B(k0, l0, j0);
+                    }
+                }
+            }
+        }
+
+        for (size_t i0 = 0; i0 < _i; i0++) {
+            for (size_t j0 = 0; j0 < _j; j0++) {
+                REQUIRE_THAT(C(i0, j0), Catch::Matchers::WithinAbs(C0(i0, j0), 0.001));
+            }
+        }
+    }
+}
+
+TEST_CASE("small target einsum", "[einsum]") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    // Targets with fewer elements than threads are summed by splitting the link space between the threads.
+    const int threads = omp_get_max_threads();
+    omp_set_num_threads(4);
+
+    size_t _i = 2, _j = 30, _k = 20, _l = 10;
+
+    SECTION("scalar") {
+        Tensor A = create_random_tensor("A", _j, _k, _l);
+        Tensor B = create_random_tensor("B", _l, _j, _k);
+        Tensor<double, 0> c{"c"};
+        c = 0.0;
+
+        REQUIRE_NOTHROW(einsum(Indices{}, &c, Indices{j, k, l}, A, Indices{l, j, k}, B));
+
+        double c0{0};
+        for (size_t j0 = 0; j0 < _j; j0++)
+            for (size_t k0 = 0; k0 < _k; k0++)
+                for (size_t l0 = 0; l0 < _l; l0++)
+                    c0 += A(j0, k0, l0) * B(l0, j0, k0);
+
+        REQUIRE_THAT(double(c), Catch::Matchers::WithinRel(c0, 1e-10));
+    }
+
+    SECTION("two elements") {
+        Tensor A = create_random_tensor("A", _j, _i, _k, _k);
+        Tensor B = create_random_tensor("B", _k, _j);
+        Tensor C = create_random_tensor("C", _i);
+        Tensor C0{C};
+
+        REQUIRE_NOTHROW(einsum(0.5, Indices{i}, &C, 2.0, Indices{j, i, k, k}, A, Indices{k, j}, B));
+
+        for (size_t i0 = 0; i0 < _i; i0++) {
+            double ci{0};
+            for (size_t j0 = 0; j0 < _j; j0++)
+                for (size_t k0 = 0; k0 < _k; k0++)
+                    ci += A(j0, i0, k0, k0) * B(k0, j0);
+            REQUIRE_THAT(C(i0), Catch::Matchers::WithinAbs(0.5 * C0(i0) + 2.0 * ci, 1e-10));
+        }
+    }
+
+    omp_set_num_threads(threads);
+}
+
+TEST_CASE("single-operand einsum", "[einsum]") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    size_t _i = 3, _j = 40, _k = 50;
+
+    SECTION("trace") {
+        Tensor A = create_random_tensor("A", _j, _k, _j, _k);
+        Tensor<double, 0> c{"c"};
+
+        REQUIRE_NOTHROW(einsum(Indices{}, &c, Indices{j, k, j, k}, A));
+
+        double c0{0};
+        for (size_t j0 = 0; j0 < _j; j0++)
+            for (size_t k0 = 0; k0 < _k; k0++)
+                c0 += A(j0, k0, j0, k0);
+
+        REQUIRE_THAT(double(c), Catch::Matchers::WithinRel(c0, 1e-12));
+    }
+
+    SECTION("diagonal") {
+        Tensor A = create_random_tensor("A", _j, _k, _j);
+        Tensor C = create_random_tensor("C", _k, _j);
+        Tensor C0{C};
+
+        REQUIRE_NOTHROW(einsum(0.5, Indices{k, j}, &C, 2.0, Indices{j, k, j}, A));
+
+        for (size_t j0 = 0; j0 < _j; j0++)
+            for (size_t k0 = 0; k0 < _k; k0++)
+                REQUIRE_THAT(C(k0, j0), Catch::Matchers::WithinAbs(0.5 * C0(k0, j0) + 2.0 * A(j0, k0, j0), 1e-12));
+    }
+
+    SECTION("partial sums") {
+        Tensor A = create_random_tensor("A", _j, _k, _i);
+        Tensor Cji{"Cji", _j, _i};
+        Tensor Cj{"Cj", _j};
+        Tensor Ci{"Ci", _i};
+
+        REQUIRE_NOTHROW(einsum(Indices{j, i}, &Cji, Indices{j, k, i}, A));
+        REQUIRE_NOTHROW(einsum(Indices{j}, &Cj, Indices{j, k, i}, A));
+        REQUIRE_NOTHROW(einsum(Indices{i}, &Ci, Indices{j, k, i}, A));
+
+        for (size_t i0 = 0; i0 < _i; i0++) {
+            double ci{0};
+            for (size_t j0 = 0; j0 < _j; j0++) {
+                double cji{0};
+                for (size_t k0 = 0; k0 < _k; k0++)
+                    cji += A(j0, k0, i0);
+                REQUIRE_THAT(Cji(j0, i0), Catch::Matchers::WithinAbs(cji, 1e-10));
+                ci += cji;
+            }
+            REQUIRE_THAT(Ci(i0), Catch::Matchers::WithinAbs(ci, 1e-10));
+        }
+        for (size_t j0 = 0; j0 < _j; j0++) {
+            double cj{0};
+            for (size_t k0 = 0; k0 < _k; k0++)
+                for (size_t i0 = 0; i0 < _i; i0++)
+                    cj += A(j0, k0, i0);
+            REQUIRE_THAT(Cj(j0), Catch::Matchers::WithinAbs(cj, 1e-10));
+        }
+    }
+
+    SECTION("sum over the slow index") {
+        Tensor A = create_random_tensor("A", _j, _k);
+        Tensor C = create_random_tensor("C", _k);
+        Tensor C0{C};
+
+        REQUIRE_NOTHROW(einsum(1.0, Indices{k}, &C, -1.0, Indices{j, k}, A));
+
+        for (size_t k0 = 0; k0 < _k; k0++) {
+            double ck{C0(k0)};
+            for (size_t j0 = 0; j0 < _j; j0++)
+                ck -= A(j0, k0);
+            REQUIRE_THAT(C(k0), Catch::Matchers::WithinAbs(ck, 1e-10));
+        }
+    }
+
+    SECTION("scaled transpose") {
+        Tensor A = create_random_tensor("A", _j, _k);
+        Tensor C{"C", _k, _j};
+
+        REQUIRE_NOTHROW(einsum(0.0, Indices{k, j}, &C, 3.0, Indices{j, k}, A));
+
+        for (size_t j0 = 0; j0 < _j; j0++)
+            for (size_t k0 = 0; k0 < _k; k0++)
+                REQUIRE_THAT(C(k0, j0), Catch::Matchers::WithinAbs(3.0 * A(j0, k0), 1e-12));
+    }
+}
+
+TEST_CASE("multi-operand einsum", "[einsum]") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    size_t _i = 2, _j = 20, _k = 20, _l = 20, _m = 5, _n = 3;
+
+    SECTION("i,l <- i,j * j,k * k,l") {
+        Tensor A = create_random_tensor("A", _i, _j);
+        Tensor B = create_random_tensor("B", _j, _k);
+        Tensor D = create_random_tensor("D", _k, _l);
+        Tensor C{"C", _i, _l};
+        Tensor C0{"C0", _i, _l};
+        C.zero();
+        C0.zero();
+
+        // Contracting the small A with B first is far cheaper than forming B * D.
+        EinsumPath path = einsum_path(Indices{i, l}, &C, Indices{i, j}, A, Indices{j, k}, B, Indices{k, l}, D);
+        REQUIRE(path.contractions.size() == 2);
+        REQUIRE(path.contractions[0] == std::pair<size_t, size_t>{0, 1});
+        REQUIRE(path.descriptions[0] == "ij,jk->ik");
+        REQUIRE(path.largest_intermediate == _i * _k);
+
+        REQUIRE_NOTHROW(einsum(Indices{i, l}, &C, Indices{i, j}, A, Indices{j, k}, B, Indices{k, l}, D));
+
+        for (size_t i0 = 0; i0 < _i; i0++) {
+            for (size_t j0 = 0; j0 < _j; j0++) {
+                for (size_t k0 = 0; k0 < _k; k0++) {
+                    for (size_t l0 = 0; l0 < _l; l0++) {
+                        C0(i0, l0) += A(i0, j0) * B(j0, k0) * D(k0, l0);
+                    }
+                }
+            }
+        }
+
+        for (size_t i0 = 0; i0 < _i; i0++) {
+            for (size_t l0 = 0; l0 < _l; l0++) {
+                REQUIRE_THAT(C(i0, l0), Catch::Matchers::WithinAbs(C0(i0, l0), 0.001));
+            }
+        }
+    }
+
+    SECTION("prefactors l,i <- i,j * k,l * j,k") {
+        Tensor A = create_random_tensor("A", _i, _j);
+        Tensor B = create_random_tensor("B", _k, _l);
+        Tensor D = create_random_tensor("D", _j, _k);
+        Tensor C = create_random_tensor("C", _l, _i);
+        Tensor C0{C};
+
+        REQUIRE_NOTHROW(einsum(2.0, Indices{l, i}, &C, 0.5, Indices{i, j}, A, Indices{k, l}, B, Indices{j, k}, D));
+
+        for (size_t i0 = 0; i0 < _i; i0++) {
+            for (size_t l0 = 0; l0 < _l; l0++) {
+                double sum{0};
+                for (size_t j0 = 0; j0 < _j; j0++) {
+                    for (size_t k0 = 0; k0 < _k; k0++) {
+                        sum += A(i0, j0) * B(k0, l0) * D(j0, k0);
+                    }
+                }
+                REQUIRE_THAT(C(l0, i0), Catch::Matchers::WithinAbs(2.0 * C0(l0, i0) + 0.5 * sum, 0.001));
+            }
+        }
+    }
+
+    SECTION("i,n <- i,j * j,k * k,l * l,m * m,n") {
+        // Five operands: the first contraction is chosen greedily, the rest by exhaustive search. Every neighbouring pair
+        // makes an intermediate of rank 2, and the dims make E * F the cheapest.
+        Tensor A = create_random_tensor("A", _i, _j);
+        Tensor B = create_random_tensor("B", _j, _k);
+        Tensor D = create_random_tensor("D", _k, _l);
+        Tensor E = create_random_tensor("E", _l, _m);
+        Tensor F = create_random_tensor("F", _m, _n);
+        Tensor C{"C", _i, _n};
+        C.zero();
+
+        EinsumPath path =
+            einsum_path(Indices{i, n}, &C, Indices{i, j}, A, Indices{j, k}, B, Indices{k, l}, D, Indices{l, m}, E, Indices{m, n}, F);
+        REQUIRE(path.contractions.size() == 4);
+        REQUIRE(path.contractions[0] == std::pair<size_t, size_t>{3, 4});
+        REQUIRE(path.descriptions[0] == "lm,mn->ln");
+
+        REQUIRE_NOTHROW(
+            einsum(Indices{i, n}, &C, Indices{i, j}, A, Indices{j, k}, B, Indices{k, l}, D, Indices{l, m}, E, Indices{m, n}, F));
+
+        Tensor AB{"AB", _i, _k};
+        Tensor ABD{"ABD", _i, _l};
+        Tensor ABDE{"ABDE", _i, _m};
+        Tensor C0{"C0", _i, _n};
+        einsum(Indices{i, k}, &AB, Indices{i, j}, A, Indices{j, k}, B);
+        einsum(Indices{i, l}, &ABD, Indices{i, k}, AB, Indices{k, l}, D);
+        einsum(Indices{i, m}, &ABDE, Indices{i, l}, ABD, Indices{l, m}, E);
+        einsum(Indices{i, n}, &C0, Indices{i, m}, ABDE, Indices{m, n}, F);
+
+        for (size_t i0 = 0; i0 < _i; i0++) {
+            for (size_t n0 = 0; n0 < _n; n0++) {
+                REQUIRE_THAT(C(i0, n0), Catch::Matchers::WithinAbs(C0(i0, n0), 0.001));
+            }
+        }
+    }
+}
+
+TEST_CASE("plan cache", "[einsum]") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    size_t _i = 10, _j = 12, _k = 14;
+
+    SECTION("sort") {
+        Tensor C{"C", _k, _i, _j};
+
+        plan_cache::clear();
+        for (int iteration = 0; iteration < 3; iteration++) {
+            // New data every time; a cached HPTT plan must not hold on to the old pointers.
+            Tensor A = create_random_tensor("A", _i, _j, _k);
+            sort(Indices{k, i, j}, &C, Indices{i, j, k}, A);
+
+            for (size_t i0 = 0; i0 < _i; i0++) {
+                for (size_t j0 = 0; j0 < _j; j0++) {
+                    for (size_t k0 = 0; k0 < _k; k0++) {
+                        REQUIRE(C(k0, i0, j0) == A(i0, j0, k0));
+                    }
+                }
+            }
+        }
+
+#if defined(EINSUMS_USE_HPTT)
+        auto statistics = plan_cache::statistics();
+        REQUIRE(statistics.misses == 1);
+        REQUIRE(statistics.hits == 2);
+#endif
+    }
+
+#if defined(EINSUMS_USE_HPTT)
+    SECTION("capacity") {
+        plan_cache::clear();
+        plan_cache::set_capacity(2);
+        auto transpose = [](size_t n) {
+            Tensor A = create_random_tensor("A", n, n + 1);
+            Tensor C{"C", n + 1, n};
+            sort(Indices{j, i}, &C, Indices{i, j}, A);
+        };
+        transpose(3);
+        transpose(4);
+        transpose(3);
+        transpose(5);
+        REQUIRE(plan_cache::statistics().entries == 2);
+
+        // The plan for 4 was the least recently used, so it was dropped.
+        transpose(3);
+        transpose(4);
+        auto statistics = plan_cache::statistics();
+        REQUIRE(statistics.hits == 2);
+        REQUIRE(statistics.misses == 4);
+
+        plan_cache::set_capacity(256);
+    }
+#endif
+
+#if defined(EINSUMS_USE_HPTT)
+    SECTION("measured sort and wisdom") {
+        Tensor A = create_random_tensor("A", _i, _j, _k, _i);
+        Tensor C{"C", _j, _i, _i, _k};
+
+        auto check = [&]() {
+            for (size_t i0 = 0; i0 < _i; i0++) {
+                for (size_t j0 = 0; j0 < _j; j0++) {
+                    for (size_t k0 = 0; k0 < _k; k0++) {
+                        for (size_t l0 = 0; l0 < _i; l0++) {
+                            REQUIRE(C(j0, l0, i0, k0) == A(i0, j0, k0, l0));
+                        }
+                    }
+                }
+            }
+        };
+
+        plan_cache::clear();
+        sort(0.0, Indices{j, l, i, k}, &C, 1.0, Indices{i, j, k, l}, A, PlanningEffort::Measure);
+        check();
+        REQUIRE(plan_cache::statistics().wisdom == 1);
+
+        plan_cache::save_wisdom("sort-wisdom.txt");
+        plan_cache::clear();
+        REQUIRE(plan_cache::statistics().wisdom == 0);
+        plan_cache::load_wisdom("sort-wisdom.txt");
+        REQUIRE(plan_cache::statistics().wisdom == 1);
+
+        // Replays the recorded candidate.
+        C.zero();
+        sort(0.0, Indices{j, l, i, k}, &C, 1.0, Indices{i, j, k, l}, A, PlanningEffort::Measure);
+        check();
+        REQUIRE(plan_cache::statistics().wisdom == 1);
+
+        std::remove("sort-wisdom.txt");
+    }
+#endif
+}
+
+TEST_CASE("einsum telemetry", "[einsum]") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    SECTION("aggregation") {
+        telemetry::clear();
+        for (int call = 0; call < 2; call++) {
+            telemetry::detail::Call outer{"C(i, j) = A(i, k) * B(k, j)", "{2,2} {2,2} {2,2}", 16, 96};
+            telemetry::detail::set_algorithm("gemm");
+        }
+        {
+            telemetry::detail::Call outer{"C(i) = A(i, j) * B(j)", "{2} {2,2} {2}", 8, 64};
+            {
+                // Only the innermost call is named.
+                telemetry::detail::Call inner{"C(i) = A(i) * B(i)", "{2} {2} {2}", 4, 48};
+                telemetry::detail::set_algorithm("element-wise");
+            }
+            telemetry::detail::set_algorithm("generic");
+        }
+        telemetry::detail::set_algorithm("ignored");
+
+        auto entries = telemetry::entries();
+        REQUIRE(entries.size() == 3);
+        for (const auto &entry : entries) {
+            if (entry.algorithm == "gemm") {
+                REQUIRE(entry.calls == 2);
+                REQUIRE(entry.flops == 32);
+                REQUIRE(entry.bytes == 192);
+            } else if (entry.algorithm == "generic") {
+                REQUIRE(entry.signature == "C(i) = A(i, j) * B(j)");
+                REQUIRE(entry.calls == 1);
+            } else {
+                REQUIRE(entry.algorithm == "element-wise");
+            }
+        }
+        REQUIRE(telemetry::is_fallback("generic"));
+        REQUIRE_FALSE(telemetry::is_fallback("gemm"));
+
+        telemetry::dump_json("telemetry.json");
+        std::ifstream json{"telemetry.json"};
+        std::string text{std::istreambuf_iterator<char>{json}, std::istreambuf_iterator<char>{}};
+        REQUIRE(text.find(R"("algorithm": "gemm", "calls": 2, "flops": 32)") != std::string::npos);
+        std::remove("telemetry.json");
+
+        telemetry::clear();
+        REQUIRE(telemetry::entries().empty());
+    }
+
+#if defined(EINSUMS_TELEMETRY)
+    SECTION("einsum") {
+        size_t _i = 10, _j = 12, _k = 14;
+        Tensor A = create_random_tensor("A", _i, _k);
+        Tensor B = create_random_tensor("B", _k, _j);
+        Tensor C{"C", _i, _j};
+
+        telemetry::clear();
+        einsum(Indices{i, j}, &C, Indices{i, k}, A, Indices{k, j}, B);
+        einsum(Indices{i, j}, &C, Indices{i, k}, A, Indices{k, j}, B);
+
+        Tensor D = create_random_tensor("D", _i, _k);
+        Tensor F = create_random_tensor("F", _j, _k);
+        Tensor E{"E", _i, _j, _k};
+        einsum(Indices{i, j, k}, &E, Indices{i, k}, D, Indices{j, k}, F);
+
+        auto entries = telemetry::entries();
+        REQUIRE(entries.size() == 2);
+        for (const auto &entry : entries) {
+            if (entry.algorithm == "gemm") {
+                REQUIRE(entry.calls == 2);
+                REQUIRE(entry.flops == 2 * 2.0 * _i * _j * _k);
+                REQUIRE(entry.dims == "{10,12} {10,14} {14,12}");
+            } else {
+                REQUIRE(telemetry::is_fallback(entry.algorithm));
+                REQUIRE(entry.flops == 2.0 * _i * _j * _k);
+            }
+        }
+        telemetry::clear();
+    }
+#endif
+}
+
+TEST_CASE("sampled einsum test", "[einsum]") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    size_t _i = 6, _j = 7, _k = 8;
+
+    SECTION("element recomputation") {
+        Tensor A = create_random_tensor("A", _i, _k, _j);
+        Tensor B = create_random_tensor("B", _k, _j);
+        Tensor C = create_random_tensor("C", _j, _i);
+        Tensor C0 = C;
+
+        auto epilogue = [](double value, size_t j, size_t i) { return value / (1.0 + i + j); };
+        einsum(0.5, Indices{j, i}, &C, 2.0, Indices{i, k, j}, A, Indices{k, j}, B, epilogue);
+
+        const auto C_unique = Indices{j, i};
+        for (size_t j0 = 0; j0 < _j; j0++) {
+            for (size_t i0 = 0; i0 < _i; i0++) {
+                const std::array<size_t, 2> target{j0, i0};
+                const double expected = tensor_algebra::detail::einsum_element(C_unique, target, 0.5, C0(j0, i0), Indices{j, i}, C, 2.0,
+                                                                               Indices{i, k, j}, A, Indices{k, j}, B, epilogue);
+                REQUIRE_THAT(expected, Catch::Matchers::WithinRel(C(j0, i0), 1.0e-12));
+            }
+        }
+    }
+
+    SECTION("sampling") {
+        const size_t samples = einsum_test_samples;
+        einsum_test_samples = 5;
+
+        REQUIRE(tensor_algebra::detail::sample_targets(Indices{i, j}, Indices{i, j}, Tensor{"C", _i, _j}, 5).size() == 5);
+        REQUIRE(tensor_algebra::detail::sample_targets(Indices{i}, Indices{i}, Tensor{"C", _i}, 6).empty());
+
+        Tensor A = create_random_tensor("A", _i, _k);
+        Tensor B = create_random_tensor("B", _k, _j);
+        Tensor C{"C", _i, _j};
+        einsum(Indices{i, j}, &C, Indices{i, k}, A, Indices{k, j}, B);
+
+        // Hadamard indices in C: only the diagonal is written and sampled.
+        Tensor E{"E", _i, _i, _j};
+        E.zero();
+        einsum(Indices{i, i, j}, &E, Indices{i, k}, A, Indices{k, j}, B);
+        REQUIRE(E(0, 1, 0) == 0.0);
+
+        Tensor<double, 0> F{"F"};
+        einsum(Indices{}, &F, Indices{i, k}, A, Indices{i, k}, A);
+
+        einsum_test_samples = samples;
+    }
+}
+
+TEST_CASE("einsum suspicious values", "[einsum]") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    SECTION("scan") {
+        Tensor A = create_random_tensor("A", 20, 30);
+        REQUIRE_FALSE(tensor_algebra::detail::has_suspicious_values(A));
+
+        A(13, 29) = std::numeric_limits<double>::quiet_NaN();
+        A(2, 4) = 1.0e9;
+        REQUIRE(tensor_algebra::detail::has_suspicious_values(A));
+        REQUIRE(tensor_algebra::detail::classify_suspicious_values(A) == tensor_algebra::detail::SuspiciousValue::NaN);
+
+        // Strided views see only their own elements.
+        TensorView<double, 2> left{A, Dim<2>{20, 10}};
+        REQUIRE(tensor_algebra::detail::has_suspicious_values(left));
+        REQUIRE(tensor_algebra::detail::classify_suspicious_values(left) == tensor_algebra::detail::SuspiciousValue::Large);
+        TensorView<double, 2> lower{A, Dim<2>{10, 20}, Offset<2>{10, 5}};
+        REQUIRE_FALSE(tensor_algebra::detail::has_suspicious_values(lower));
+    }
+
+#if defined(EINSUMS_TEST_NANS)
+    SECTION("einsum") {
+        Tensor A = create_random_tensor("A", 10, 12);
+        Tensor B = create_random_tensor("B", 12, 8);
+        Tensor C{"C", 10, 8};
+
+        A(3, 4) = std::numeric_limits<double>::infinity();
+        REQUIRE_THROWS(einsum(Indices{i, j}, &C, Indices{i, k}, A, Indices{k, j}, B));
+
+        // Checked by the epilogue as each element is stored.
+        A(3, 4) = 1.0;
+        auto divide = [](double value, size_t i, size_t j) { return value / static_cast<double>(i * j); };
+        REQUIRE_THROWS(einsum(Indices{i, j}, &C, Indices{i, k}, A, Indices{k, j}, B, divide));
+
+        auto shift = [](double value, size_t i, size_t j) { return value / static_cast<double>(1 + i * j); };
+        REQUIRE_NOTHROW(einsum(Indices{i, j}, &C, Indices{i, k}, A, Indices{k, j}, B, shift));
+    }
+#endif
+}
+
+TEST_CASE("symmetric tensor", "[einsum]") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    const size_t n = 7;
+
+    const Symmetry symmetry = GENERATE(Symmetry::EightFold, Symmetry::FourFold);
+    SymmetricTensor<double> g{"g", n, symmetry};
+    REQUIRE(g.size() == SymmetricTensor<double>::packed_size(n, symmetry));
+    Tensor random = create_random_tensor("random", g.size());
+    std::copy(random.data(), random.data() + g.size(), g.data());
+
+    Tensor<double, 4> dense = g.unpack();
+
+    SECTION("packing") {
+        for (size_t p = 0; p < n; p++) {
+            for (size_t q = 0; q < n; q++) {
+                for (size_t r = 0; r < n; r++) {
+                    for (size_t s = 0; s < n; s++) {
+                        REQUIRE(dense(p, q, r, s) == g(p, q, r, s));
+                        REQUIRE(dense(p, q, r, s) == dense(q, p, s, r));
+                        if (symmetry == Symmetry::EightFold)
+                            REQUIRE(dense(p, q, r, s) == dense(r, s, q, p));
+                    }
+                }
+            }
+        }
+
+        SymmetricTensor<double> packed{dense, symmetry};
+        REQUIRE(std::equal(packed.data(), packed.data() + packed.size(), g.data()));
+    }
+
+    SECTION("unpack block") {
+        Tensor<double, 4> target{"target", 5, 5, 5, 5};
+        target.zero();
+        TensorView<double, 4> block{target, Dim<4>{3, 2, 4, 2}, Offset<4>{1, 1, 0, 2}};
+        g.unpack_block(Offset<4>{4, 2, 3, 0}, &block);
+
+        for (size_t i = 0; i < 3; i++) {
+            for (size_t j = 0; j < 2; j++) {
+                for (size_t k = 0; k < 4; k++) {
+                    for (size_t l = 0; l < 2; l++) {
+                        REQUIRE(target(1 + i, 1 + j, k, 2 + l) == dense(4 + i, 2 + j, 3 + k, l));
+                    }
+                }
+            }
+        }
+        REQUIRE(target(0, 0, 0, 0) == 0.0);
+    }
+
+    SECTION("einsum") {
+        Tensor D = create_random_tensor("D", n, n);
+        Tensor v = create_random_tensor("v", n);
+
+        // Coulomb: the first index of g is in C.
+        Tensor J{"J", n, n}, J_dense{"J dense", n, n};
+        einsum(Indices{p, q}, &J, Indices{p, q, r, s}, g, Indices{r, s}, D);
+        einsum(Indices{p, q}, &J_dense, Indices{p, q, r, s}, dense, Indices{r, s}, D);
+
+        // Exchange, with g as the second operand.
+        Tensor K = create_random_tensor("K", n, n);
+        Tensor K_dense = K;
+        einsum(0.5, Indices{p, r}, &K, 2.0, Indices{q, s}, D, Indices{p, q, r, s}, g);
+        einsum(0.5, Indices{p, r}, &K_dense, 2.0, Indices{q, s}, D, Indices{p, q, r, s}, dense);
+
+        // The first index of g is summed over.
+        Tensor X = create_random_tensor("X", n, n, n);
+        Tensor X_dense = X;
+        einsum(0.5, Indices{q, r, s}, &X, 1.0, Indices{p, q, r, s}, g, Indices{p}, v);
+        einsum(0.5, Indices{q, r, s}, &X_dense, 1.0, Indices{p, q, r, s}, dense, Indices{p}, v);
+
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                REQUIRE_THAT(J(i, j), Catch::Matchers::WithinAbs(J_dense(i, j), 1.0e-12));
+                REQUIRE_THAT(K(i, j), Catch::Matchers::WithinAbs(K_dense(i, j), 1.0e-12));
+                for (size_t k = 0; k < n; k++)
+                    REQUIRE_THAT(X(i, j, k), Catch::Matchers::WithinAbs(X_dense(i, j, k), 1.0e-12));
+            }
+        }
+    }
+}
+
+TEST_CASE("block tensor", "[einsum]") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    auto fill = [](auto &block) {
+        Tensor random = create_random_tensor("random", block.size());
+        std::copy(random.data(), random.data() + block.size(), block.data());
+    };
+
+    SECTION("block diagonal gemm") {
+        const std::vector<size_t> irreps{3, 1, 4, 2};
+        BlockTensor<double, 2> A{"A", {irreps, irreps}}, B{"B", {irreps, irreps}}, C{"C", {irreps, irreps}};
+        for (size_t h = 0; h < irreps.size(); h++) {
+            fill(A.block({h, h}));
+            fill(B.block({h, h}));
+        }
+        fill(C.block({0, 0}));
+        fill(C.block({1, 2}));
+
+        Tensor<double, 2> C_dense = C.dense();
+        einsum(0.5, Indices{i, j}, &C, 2.0, Indices{i, k}, A, Indices{k, j}, B);
+        einsum(0.5, Indices{i, j}, &C_dense, 2.0, Indices{i, k}, A.dense(), Indices{k, j}, B.dense());
+
+        REQUIRE(C.blocks().size() == irreps.size() + 1);
+        for (size_t x = 0; x < C.dim(0); x++) {
+            for (size_t y = 0; y < C.dim(1); y++)
+                REQUIRE_THAT(C(x, y), Catch::Matchers::WithinAbs(C_dense(x, y), 1.0e-12));
+        }
+    }
+
+    SECTION("symmetry blocked contraction") {
+        // Blocks of a totally symmetric quantity in a group with two irreps.
+        const std::vector<size_t> occupied{3, 2}, virtuals{5, 4};
+        BlockTensor<double, 4> T2{"T2", {occupied, occupied, virtuals, virtuals}}, W{"W", {virtuals, virtuals, virtuals, virtuals}};
+        BlockTensor<double, 4> R{"R", {occupied, occupied, virtuals, virtuals}};
+        for (size_t p = 0; p < 2; p++) {
+            for (size_t q = 0; q < 2; q++) {
+                for (size_t r = 0; r < 2; r++) {
+                    fill(T2.block({p, q, r, p ^ q ^ r}));
+                    fill(W.block({p, q, r, p ^ q ^ r}));
+                }
+            }
+        }
+
+        const int threads = omp_get_max_threads();
+        omp_set_num_threads(3);
+        einsum(Indices{i, j, a, b}, &R, Indices{i, j, c, d}, T2, Indices{c, d, a, b}, W);
+        omp_set_num_threads(threads);
+
+        Tensor<double, 4> R_dense{"R dense", 5, 5, 9, 9};
+        einsum(Indices{i, j, a, b}, &R_dense, Indices{i, j, c, d}, T2.dense(), Indices{c, d, a, b}, W.dense());
+
+        REQUIRE(R.blocks().size() == 8);
+        for (size_t w = 0; w < 5; w++) {
+            for (size_t x = 0; x < 5; x++) {
+                for (size_t y = 0; y < 9; y++) {
+                    for (size_t z = 0; z < 9; z++)
+                        REQUIRE_THAT(R(w, x, y, z), Catch::Matchers::WithinAbs(R_dense(w, x, y, z), 1.0e-12));
+                }
+            }
+        }
+    }
+
+    SECTION("partitions must match") {
+        const std::vector<size_t> even{2, 2}, uneven{1, 3};
+        BlockTensor<double, 2> A{"A", {even, even}}, B{"B", {uneven, even}}, C{"C", {even, even}};
+        REQUIRE_THROWS(einsum(Indices{i, j}, &C, Indices{i, k}, A, Indices{k, j}, B));
+    }
+}
+
+TEST_CASE("sparse tensor", "[einsum]") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    // Roughly a fifth of the elements are kept.
+    auto screened = [](auto &&dense) {
+        std::for_each(dense.data(), dense.data() + dense.size(), [](double &value) { value = value > 0.8 ? value : 0.0; });
+        return dense;
+    };
+
+    const size_t n = 9;
+    Tensor<double, 4> g_dense = screened(create_random_tensor("g", n, n, n, n));
+    SparseTensor<double, 4> g{g_dense};
+
+    SECTION("conversion") {
+        REQUIRE(g.nnz() == static_cast<size_t>(std::count_if(g_dense.data(), g_dense.data() + g_dense.size(),
+                                                             [](double value) { return value != 0.0; })));
+        Tensor<double, 4> round_trip = g.dense();
+        REQUIRE(std::equal(round_trip.data(), round_trip.data() + round_trip.size(), g_dense.data()));
+        REQUIRE(g(1, 2, 3, 4) == g_dense(1, 2, 3, 4));
+
+        SparseTensor<double, 2> m{"m", 3, 4};
+        m.insert({2, 1}, 1.0);
+        m.insert({0, 3}, 2.0);
+        m.insert({2, 1}, 0.5);
+        m.compress();
+        m.insert({0, 0}, 4.0);
+        REQUIRE_THROWS(m(0, 0));
+        m.compress();
+        REQUIRE(m.nnz() == 3);
+        REQUIRE(m.fibers() == 2);
+        REQUIRE(m(2, 1) == 1.5);
+        REQUIRE(m(0, 0) == 4.0);
+        REQUIRE(m(1, 1) == 0.0);
+        REQUIRE_THROWS(m.insert({3, 0}, 1.0));
+    }
+
+    SECTION("einsum") {
+        Tensor D = create_random_tensor("D", n, n);
+        Tensor v = create_random_tensor("v", n);
+
+        // The first index of g is an index of C.
+        Tensor J = create_random_tensor("J", n, n);
+        Tensor J_dense = J;
+        einsum(0.5, Indices{p, q}, &J, 2.0, Indices{p, q, r, s}, g, Indices{r, s}, D);
+        einsum(0.5, Indices{p, q}, &J_dense, 2.0, Indices{p, q, r, s}, g_dense, Indices{r, s}, D);
+
+        // The first index of g is summed over, and g is the second operand.
+        Tensor X{"X", n, n, n}, X_dense{"X dense", n, n, n};
+        einsum(Indices{q, r, s}, &X, Indices{p}, v, Indices{p, q, r, s}, g);
+        einsum(Indices{q, r, s}, &X_dense, Indices{p}, v, Indices{p, q, r, s}, g_dense);
+
+        // Indices of B that are not indices of g.
+        Tensor Z = create_random_tensor("Z", n, n, n);
+        Tensor Y{"Y", n, n, n}, Y_dense{"Y dense", n, n, n};
+        einsum(Indices{p, q, t}, &Y, Indices{p, q, r, s}, g, Indices{r, s, t}, Z);
+        einsum(Indices{p, q, t}, &Y_dense, Indices{p, q, r, s}, g_dense, Indices{r, s, t}, Z);
+
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                REQUIRE_THAT(J(i, j), Catch::Matchers::WithinAbs(J_dense(i, j), 1.0e-12));
+                for (size_t k = 0; k < n; k++) {
+                    REQUIRE_THAT(X(i, j, k), Catch::Matchers::WithinAbs(X_dense(i, j, k), 1.0e-12));
+                    REQUIRE_THAT(Y(i, j, k), Catch::Matchers::WithinAbs(Y_dense(i, j, k), 1.0e-12));
+                }
+            }
+        }
+    }
+
+    SECTION("spmm") {
+        Tensor<double, 2> A_dense = screened(create_random_tensor("A", 30, 20));
+        SparseTensor<double, 2> A{A_dense};
+        Tensor B = create_random_tensor("B", 20, 25);
+        Tensor Bt = create_random_tensor("Bt", 25, 20);
+
+        Tensor C = create_random_tensor("C", 30, 25);
+        Tensor C_dense = C;
+        einsum(0.5, Indices{i, j}, &C, 2.0, Indices{i, k}, A, Indices{k, j}, B);
+        einsum(0.5, Indices{i, j}, &C_dense, 2.0, Indices{i, k}, A_dense, Indices{k, j}, B);
+
+        Tensor<double, 2> Ct{"Ct", 30, 25}, Ct_dense{"Ct dense", 30, 25};
+        einsum(Indices{i, j}, &Ct, Indices{i, k}, A, Indices{j, k}, Bt);
+        einsum(Indices{i, j}, &Ct_dense, Indices{i, k}, A_dense, Indices{j, k}, Bt);
+
+        Tensor E = create_random_tensor("E", 30, 25);
+        Tensor<double, 2> F{"F", 20, 25}, F_dense{"F dense", 20, 25};
+        linear_algebra::gemm<true, false>(1.0, A, E, 0.0, &F);
+        linear_algebra::gemm<true, false>(1.0, A_dense, E, 0.0, &F_dense);
+
+        // Views of B and C whose last index is not contiguous.
+        Tensor B3 = create_random_tensor("B3", 20, 25, 3);
+        Tensor<double, 2> Cs{"Cs", 30, 25}, Cs_dense{"Cs dense", 30, 25};
+        einsum(Indices{i, j}, &Cs, Indices{i, k}, A, Indices{k, j}, B3(All, All, 1));
+        einsum(Indices{i, j}, &Cs_dense, Indices{i, k}, A_dense, Indices{k, j}, B3(All, All, 1));
+
+        Tensor<double, 3> G3{"G3", 20, 25, 2};
+        G3.zero();
+        TensorView G = G3(All, All, 1);
+        Tensor<double, 2> G_dense{"G dense", 20, 25};
+        linear_algebra::gemm<true, false>(1.0, A, E, 0.0, &G);
+        linear_algebra::gemm<true, false>(1.0, A_dense, E, 0.0, &G_dense);
+
+        for (size_t x = 0; x < 30; x++) {
+            for (size_t y = 0; y < 25; y++) {
+                REQUIRE_THAT(C(x, y), Catch::Matchers::WithinAbs(C_dense(x, y), 1.0e-12));
+                REQUIRE_THAT(Ct(x, y), Catch::Matchers::WithinAbs(Ct_dense(x, y), 1.0e-12));
+                REQUIRE_THAT(Cs(x, y), Catch::Matchers::WithinAbs(Cs_dense(x, y), 1.0e-12));
+                if (x < 20) {
+                    REQUIRE_THAT(F(x, y), Catch::Matchers::WithinAbs(F_dense(x, y), 1.0e-12));
+                    REQUIRE_THAT(G(x, y), Catch::Matchers::WithinAbs(G_dense(x, y), 1.0e-12));
+                    REQUIRE(G3(x, y, 0) == 0.0);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("einsum epilogue", "[einsum]") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    SECTION("gemm i,j <- i,k * k,j / (e_i + e_j)") {
+        // Wide enough that C is computed in several blocks of rows.
+        size_t _i = 40, _j = 4096, _k = 3;
+        Tensor A = create_random_tensor("A", _i, _k);
+        Tensor B = create_random_tensor("B", _k, _j);
+        Tensor e = create_random_tensor("e", _j);
+        Tensor C{"C", _i, _j};
+        for (size_t j0 = 0; j0 < _j; j0++)
+            e(j0) += 1.0;
+
+        einsum(0.0, Indices{i, j}, &C, 1.0, Indices{i, k}, A, Indices{k, j}, B,
+               [&](double value, size_t i0, size_t j0) { return value / (e(i0) + e(j0)); });
+
+        for (size_t i0 = 0; i0 < _i; i0++) {
+            for (size_t j0 = 0; j0 < _j; j0++) {
+                double value{0.0};
+                for (size_t k0 = 0; k0 < _k; k0++)
+                    value += A(i0, k0) * B(k0, j0);
+                REQUIRE_THAT(C(i0, j0), Catch::Matchers::WithinAbs(value / (e(i0) + e(j0)), 1.0E-10));
+            }
+        }
+    }
+
+    SECTION("transposed gemm j,i <- i,k * k,j") {
+        size_t _i = 30, _j = 40, _k = 5;
+        Tensor A = create_random_tensor("A", _i, _k);
+        Tensor B = create_random_tensor("B", _k, _j);
+        Tensor C = create_random_tensor("C", _j, _i);
+        Tensor C0 = C;
+
+        einsum(1.0, Indices{j, i}, &C, 2.0, Indices{i, k}, A, Indices{k, j}, B,
+               [](double value, size_t j0, size_t i0) { return value + static_cast<double>(100 * j0 + i0); });
+
+        for (size_t i0 = 0; i0 < _i; i0++) {
+            for (size_t j0 = 0; j0 < _j; j0++) {
+                double value{C0(j0, i0)};
+                for (size_t k0 = 0; k0 < _k; k0++)
+                    value += 2.0 * A(i0, k0) * B(k0, j0);
+                REQUIRE_THAT(C(j0, i0), Catch::Matchers::WithinAbs(value + static_cast<double>(100 * j0 + i0), 1.0E-10));
+            }
+        }
+    }
+
+    SECTION("ttgt m,b,e,j <- j,n,f,b * m,n,e,f") {
+        size_t _m = 6, _n = 7, _e = 5, _f = 4, _b = 3, _j = 8;
+        Tensor A = create_random_tensor("A", _j, _n, _f, _b);
+        Tensor B = create_random_tensor("B", _m, _n, _e, _f);
+        Tensor C{"C", _m, _b, _e, _j};
+
+        einsum(Indices{m, b, e, j}, &C, Indices{j, n, f, b}, A, Indices{m, n, e, f}, B,
+               [](double value, size_t m0, size_t b0, size_t e0, size_t j0) { return value * static_cast<double>(1 + m0 + b0 + e0 + j0); });
+
+        for (size_t m0 = 0; m0 < _m; m0++) {
+            for (size_t b0 = 0; b0 < _b; b0++) {
+                for (size_t e0 = 0; e0 < _e; e0++) {
+                    for (size_t j0 = 0; j0 < _j; j0++) {
+                        double value{0.0};
+                        for (size_t n0 = 0; n0 < _n; n0++) {
+                            for (size_t f0 = 0; f0 < _f; f0++) {
+                                value += A(j0, n0, f0, b0) * B(m0, n0, e0, f0);
+                            }
+                        }
+                        value *= static_cast<double>(1 + m0 + b0 + e0 + j0);
+                        REQUIRE_THAT(C(m0, b0, e0, j0), Catch::Matchers::WithinAbs(value, 1.0E-10));
+                    }
+                }
+            }
+        }
+    }
+
+    SECTION("ttgt in place Q,i,j <- k,Q,i * Q,k,j") {
+        size_t _Q = 5, _i = 6, _j = 7, _k = 8;
+        Tensor A = create_random_tensor("A", _k, _Q, _i);
+        Tensor B = create_random_tensor("B", _Q, _k, _j);
+        Tensor C = create_random_tensor("C", _Q, _i, _j);
+        Tensor C0 = C;
+
+        einsum(0.5, Indices{Q, i, j}, &C, 2.0, Indices{k, Q, i}, A, Indices{Q, k, j}, B,
+               [](double value, size_t Q0, size_t i0, size_t j0) { return value - static_cast<double>(Q0 * i0 + j0); });
+
+        for (size_t Q0 = 0; Q0 < _Q; Q0++) {
+            for (size_t i0 = 0; i0 < _i; i0++) {
+                for (size_t j0 = 0; j0 < _j; j0++) {
+                    double value{0.5 * C0(Q0, i0, j0)};
+                    for (size_t k0 = 0; k0 < _k; k0++)
+                        value += 2.0 * A(k0, Q0, i0) * B(Q0, k0, j0);
+                    value -= static_cast<double>(Q0 * i0 + j0);
+                    REQUIRE_THAT(C(Q0, i0, j0), Catch::Matchers::WithinAbs(value, 1.0E-10));
+                }
+            }
+        }
+    }
+
+    SECTION("strided i,j <- i,k,l,k * k,l,j") {
+        size_t _i = 4, _j = 8, _k = 6, _l = 5;
+        Tensor A = create_random_tensor("A", _i, _k, _l, _k);
+        Tensor B = create_random_tensor("B", _k, _l, _j);
+        Tensor C{"C", _i, _j};
+
+        einsum(Indices{i, j}, &C, Indices{i, k, l, k}, A, Indices{k, l, j}, B,
+               [](double value, size_t i0, size_t j0) { return i0 == j0 ? 0.0 : -value; });
+
+        for (size_t i0 = 0; i0 < _i; i0++) {
+            for (size_t j0 = 0; j0 < _j; j0++) {
+                double value{0.0};
+                for (size_t k0 = 0; k0 < _k; k0++) {
+                    for (size_t l0 = 0; l0 < _l; l0++) {
+                        value += A(i0, k0, l0, k0) * B(k0, l0, j0);
+                    }
+                }
+                REQUIRE_THAT(C(i0, j0), Catch::Matchers::WithinAbs(i0 == j0 ? 0.0 : -value, 1.0E-10));
+            }
+        }
+    }
+}
+
+TEST_CASE("batched gemm", "[einsum]") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    size_t _Q = 5, _i = 4, _j = 3, _k = 6;
+
+    SECTION("Q,i,j <- Q,i,k * Q,k,j") {
+        Tensor A = create_random_tensor("A", _Q, _i, _k);
+        Tensor B = create_random_tensor("B", _Q, _k, _j);
+        Tensor C{"C", _Q, _i, _j};
+        Tensor C0{"C0", _Q, _i, _j};
+        C.zero();
+        C0.zero();
+
+        REQUIRE_NOTHROW(einsum(Indices{Q, i, j}, &C, Indices{Q, i, k}, A, Indices{Q, k, j}, B));
+
+        for (size_t Q0 = 0; Q0 < _Q; Q0++) {
+            for (size_t i0 = 0; i0 < _i; i0++) {
+                for (size_t j0 = 0; j0 < _j; j0++) {
+                    for (size_t k0 = 0; k0 < _k; k0++) {
+                        C0(Q0, i0, j0) += A(Q0, i0, k0) * B(Q0, k0, j0);
+                    }
+                }
+            }
+        }
+
+        for (size_t Q0 = 0; Q0 < _Q; Q0++) {
+            for (size_t i0 = 0; i0 < _i; i0++) {
+                for (size_t j0 = 0; j0 < _j; j0++) {
+                    REQUIRE_THAT(C(Q0, i0, j0), Catch::Matchers::WithinAbs(C0(Q0, i0, j0), 0.001));
+                }
+            }
+        }
+    }
+
+    SECTION("Q,j,i <- Q,k,i * Q,j,k") {
+        Tensor A = create_random_tensor("A", _Q, _k, _i);
+        Tensor B = create_random_tensor("B", _Q, _j, _k);
+        Tensor C{"C", _Q, _j, _i};
+        Tensor C0{"C0", _Q, _j, _i};
+        C.zero();
+        C0.zero();
+
+        REQUIRE_NOTHROW(einsum(Indices{Q, j, i}, &C, Indices{Q, k, i}, A, Indices{Q, j, k}, B));
+
+        for (size_t Q0 = 0; Q0 < _Q; Q0++) {
+            for (size_t i0 = 0; i0 < _i; i0++) {
+                for (size_t j0 = 0; j0 < _j; j0++) {
+                    for (size_t k0 = 0; k0 < _k; k0++) {
+                        C0(Q0, j0, i0) += A(Q0, k0, i0) * B(Q0, j0, k0);
+                    }
+                }
+            }
+        }
+
+        for (size_t Q0 = 0; Q0 < _Q; Q0++) {
+            for (size_t i0 = 0; i0 < _i; i0++) {
+                for (size_t j0 = 0; j0 < _j; j0++) {
+                    REQUIRE_THAT(C(Q0, j0, i0), Catch::Matchers::WithinAbs(C0(Q0, j0, i0), 0.001));
+                }
+            }
+        }
+    }
+
+    SECTION("i,Q,j <- i,Q,k * k,Q,j") {
+        Tensor A = create_random_tensor("A", _i, _Q, _k);
+        Tensor B = create_random_tensor("B", _k, _Q, _j);
+        Tensor C{"C", _i, _Q, _j};
+        Tensor C0{"C0", _i, _Q, _j};
+        C.zero();
+        C0.zero();
+
+        REQUIRE_NOTHROW(einsum(Indices{i, Q, j}, &C, Indices{i, Q, k}, A, Indices{k, Q, j}, B));
+
+        for (size_t Q0 = 0; Q0 < _Q; Q0++) {
+            for (size_t i0 = 0; i0 < _i; i0++) {
+                for (size_t j0 = 0; j0 < _j; j0++) {
+                    for (size_t k0 = 0; k0 < _k; k0++) {
+                        C0(i0, Q0, j0) += A(i0, Q0, k0) * B(k0, Q0, j0);
+                    }
+                }
+            }
+        }
+
+        for (size_t Q0 = 0; Q0 < _Q; Q0++) {
+            for (size_t i0 = 0; i0 < _i; i0++) {
+                for (size_t j0 = 0; j0 < _j; j0++) {
+                    REQUIRE_THAT(C(i0, Q0, j0), Catch::Matchers::WithinAbs(C0(i0, Q0, j0), 0.001));
+                }
+            }
+        }
+    }
+}
+
 TEST_CASE("gemv") {
     using namespace einsums;
     using namespace einsums::tensor_algebra;
@@ -1775,6 +2932,69 @@ TEST_CASE("TensorView einsum") {
     }
 }
 
+TEST_CASE("TensorView BLAS layouts") {
+    using namespace einsums;
+    using namespace einsums::tensor_algebra;
+    using namespace einsums::tensor_algebra::index;
+
+    // Blocks of larger tensors. Those whose grouped indices fuse are passed to BLAS with their leading dimensions, the
+    // others fall back to the strided algorithm.
+    Tensor A = create_random_tensor("A", 10, 8, 6);
+    Tensor B = create_random_tensor("B", 8, 6, 12);
+    Tensor x = create_random_tensor("x", 8, 6);
+    Tensor C = create_random_tensor("C", 20, 20);
+
+    auto check = [&](const auto &Av, const auto &Bv, size_t rows, size_t columns) {
+        Tensor C0{C};
+        TensorView<double, 2> Cv{C, Dim<2>{rows, columns}, Offset<2>{1, 2}};
+
+        REQUIRE_NOTHROW(einsum(0.5, Indices{i, j}, &Cv, 2.0, Indices{i, a, b}, Av, Indices{a, b, j}, Bv));
+
+        for (size_t i0 = 0; i0 < 20; i0++) {
+            for (size_t j0 = 0; j0 < 20; j0++) {
+                double expected = C0(i0, j0);
+                if (i0 >= 1 && i0 < 1 + rows && j0 >= 2 && j0 < 2 + columns) {
+                    double sum{0};
+                    for (size_t a0 = 0; a0 < Av.dim(1); a0++)
+                        for (size_t b0 = 0; b0 < Av.dim(2); b0++)
+                            sum += Av(i0 - 1, a0, b0) * Bv(a0, b0, j0 - 2);
+                    expected = 0.5 * expected + 2.0 * sum;
+                }
+                REQUIRE_THAT(C(i0, j0), Catch::Matchers::WithinAbs(expected, 1e-10));
+            }
+        }
+    };
+
+    SECTION("gemm on fusable blocks") {
+        TensorView<double, 3> Av{A, Dim<3>{4, 8, 6}, Offset<3>{3, 0, 0}};
+        TensorView<double, 3> Bv{B, Dim<3>{8, 6, 5}, Offset<3>{0, 0, 2}};
+        check(Av, Bv, 4, 5);
+    }
+
+    SECTION("blocks that cannot be fused") {
+        TensorView<double, 3> Av{A, Dim<3>{4, 5, 3}, Offset<3>{3, 1, 2}};
+        TensorView<double, 3> Bv{B, Dim<3>{5, 3, 5}, Offset<3>{2, 1, 2}};
+        check(Av, Bv, 4, 5);
+    }
+
+    SECTION("gemv on a block") {
+        TensorView<double, 3> Av{A, Dim<3>{4, 8, 6}, Offset<3>{5, 0, 0}};
+        TensorView<double, 1> yv{C, Dim<1>{4}, Offset<2>{3, 0}, Stride<1>{20}};
+        Tensor y0{C};
+
+        REQUIRE_NOTHROW(einsum(Indices{i}, &yv, Indices{i, a, b}, Av, Indices{a, b}, x));
+
+        for (size_t i0 = 0; i0 < 4; i0++) {
+            double sum{0};
+            for (size_t a0 = 0; a0 < 8; a0++)
+                for (size_t b0 = 0; b0 < 6; b0++)
+                    sum += A(i0 + 5, a0, b0) * x(a0, b0);
+            REQUIRE_THAT(C(i0 + 3, 0), Catch::Matchers::WithinAbs(sum, 1e-10));
+            REQUIRE_THAT(C(i0 + 3, 1), Catch::Matchers::WithinAbs(y0(i0 + 3, 1), 1e-14));
+        }
+    }
+}
+
 TEST_CASE("outer product") {
     using namespace einsums;
     using namespace einsums::tensor_algebra;
@@ -2378,6 +3598,28 @@ TEST_CASE("einsum-mixed") {
     SECTION("d-d-d") {
         einsum_mixed_test<double, double, double>();
     }
+    SECTION("f-d-f with prefactors") {
+        using namespace einsums;
+        using namespace einsums::tensor_algebra;
+        using namespace einsums::tensor_algebra::index;
+
+        auto A = create_random_tensor<double>("A", 12, 8);
+        auto B = create_random_tensor<float>("B", 8, 12);
+        auto C = create_random_tensor<float>("C", 12, 12);
+        auto C0 = C;
+
+        einsum(0.5, Indices{i, j}, &C, 2.0, Indices{i, k}, A, Indices{k, j}, B);
+
+        for (size_t i = 0; i < 12; i++) {
+            for (size_t j = 0; j < 12; j++) {
+                double value = 0.5 * C0(i, j);
+                for (size_t k = 0; k < 8; k++) {
+                    value += 2.0 * A(i, k) * B(k, j);
+                }
+                CHECK(std::abs(C(i, j) - value) < 1.0E-4);
+            }
+        }
+    }
     // VERY SENSITIVE
     // SECTION("cf-cd-f") {
     //     einsum_mixed_test<std::complex<float>, std::complex<float>, std::complex<float>>();
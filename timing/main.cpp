@@ -174,7 +174,7 @@ auto main() -> int {
 
     {
         Section section{"disk write"};
-        g(All, All, All, All) = eri;
+        g(Access::WriteDiscard, All, All, All, All) = eri;
     }
     timer::report();
     blas::finalize();